@@ -7,6 +7,9 @@
 #include <ala/detail/sort.h>
 #include <ala/detail/allocator.h>
 #include <ala/detail/uninitialized_memory.h>
+#include <ala/detail/simd/minmax.h>
+#include <ala/detail/simd/search.h>
+#include <ala/detail/simd/set.h>
 
 namespace ala {
 
@@ -35,12 +38,30 @@ constexpr bool none_of(InputIter first, InputIter last, UnaryPred pred) {
 }
 
 template<class InputIter, class Fn>
-constexpr Fn for_each(InputIter first, InputIter last, Fn f) {
+constexpr Fn _for_each_dispatch(InputIter first, InputIter last, Fn f,
+                                false_type) {
     for (; first != last; ++first)
         f(*first);
     return f;
 }
 
+// f runs over raw pointers of each piece
+template<class InputIter, class Fn>
+Fn _for_each_dispatch(InputIter first, InputIter last, Fn f, true_type) {
+    using local_t = _local_iter_t<InputIter>;
+    ala::for_each_segment(first, last, [&](local_t l, local_t r) {
+        for (; l != r; ++l)
+            f(*l);
+    });
+    return f;
+}
+
+template<class InputIter, class Fn>
+constexpr Fn for_each(InputIter first, InputIter last, Fn f) {
+    return ala::_for_each_dispatch(first, last, ala::move(f),
+                                   _is_segmented_iter<InputIter>{});
+}
+
 template<class InputIter, class Size, class Fn>
 constexpr InputIter for_each_n(InputIter first, Size count, Fn f) {
     auto n = ala::_convert_to_integral(count);
@@ -50,9 +71,9 @@ constexpr InputIter for_each_n(InputIter first, Size count, Fn f) {
 }
 
 template<class ForwardIter1, class ForwardIter2, class BinPred>
-constexpr ForwardIter1 search(ForwardIter1 first1, ForwardIter1 last1,
-                              ForwardIter2 first2, ForwardIter2 last2,
-                              BinPred pred) {
+constexpr ForwardIter1 _search_dispatch(ForwardIter1 first1, ForwardIter1 last1,
+                                        ForwardIter2 first2, ForwardIter2 last2,
+                                        BinPred pred, false_type) {
     for (;; ++first1) {
         ForwardIter1 i = first1;
         for (ForwardIter2 j = first2;; ++i, (void)++j) {
@@ -66,6 +87,33 @@ constexpr ForwardIter1 search(ForwardIter1 first1, ForwardIter1 last1,
     }
 }
 
+template<class ForwardIter1, class ForwardIter2, class BinPred>
+constexpr ForwardIter1 _search_dispatch(ForwardIter1 first1, ForwardIter1 last1,
+                                        ForwardIter2 first2, ForwardIter2 last2,
+                                        BinPred pred, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_search_dispatch(first1, last1, first2, last2, pred,
+                                     false_type{});
+#endif
+    size_t n = last1 - first1;
+    return first1 + ala::intrin::simd_search(ala::to_address(first1), n,
+                                             ala::to_address(first2),
+                                             last2 - first2);
+}
+
+// byte ranges use a first/last byte filter, see ala::intrin::simd_search
+template<class ForwardIter1, class ForwardIter2, class BinPred>
+constexpr ForwardIter1 search(ForwardIter1 first1, ForwardIter1 last1,
+                              ForwardIter2 first2, ForwardIter2 last2,
+                              BinPred pred) {
+    using T = _simd_value_t<ForwardIter1>;
+    using tag_t = _and_<_is_simd_iter2<ForwardIter1, ForwardIter2>,
+                        bool_constant<is_integral<T>::value && sizeof(T) == 1>,
+                        _is_simd_equal_to<BinPred, T>>;
+    return ala::_search_dispatch(first1, last1, first2, last2, pred, tag_t{});
+}
+
 template<class ForwardIter1, class ForwardIter2>
 constexpr ForwardIter1 search(ForwardIter1 first1, ForwardIter1 last1,
                               ForwardIter2 first2, ForwardIter2 last2) {
@@ -120,8 +168,9 @@ constexpr InputIter find_first_of(InputIter first1, InputIter last1,
 }
 
 template<class ForwardIter, class BinPred>
-constexpr ForwardIter adjacent_find(ForwardIter first, ForwardIter last,
-                                    BinPred pred) {
+constexpr ForwardIter _adjacent_find_dispatch(ForwardIter first,
+                                              ForwardIter last, BinPred pred,
+                                              false_type) {
     if (first == last)
         return last;
     ForwardIter next = first;
@@ -131,6 +180,31 @@ constexpr ForwardIter adjacent_find(ForwardIter first, ForwardIter last,
     return last;
 }
 
+template<class ForwardIter, class BinPred>
+constexpr ForwardIter _adjacent_find_dispatch(ForwardIter first,
+                                              ForwardIter last, BinPred pred,
+                                              true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_adjacent_find_dispatch(first, last, pred, false_type{});
+#endif
+    size_t n = last - first;
+    if (n < 2)
+        return last;
+    const auto *p = ala::to_address(first);
+    size_t i = ala::intrin::simd_mismatch<true>(p, p + 1, n - 1);
+    return i == n - 1 ? last : first + i;
+}
+
+template<class ForwardIter, class BinPred>
+constexpr ForwardIter adjacent_find(ForwardIter first, ForwardIter last,
+                                    BinPred pred) {
+    using tag_t =
+        _and_<_is_simd_iter<ForwardIter>,
+              _is_simd_equal_to<BinPred, _simd_value_t<ForwardIter>>>;
+    return ala::_adjacent_find_dispatch(first, last, pred, tag_t{});
+}
+
 template<class ForwardIter>
 constexpr ForwardIter adjacent_find(ForwardIter first, ForwardIter last) {
     return ala::adjacent_find(first, last, ala::equal_to<>());
@@ -138,7 +212,7 @@ constexpr ForwardIter adjacent_find(ForwardIter first, ForwardIter last) {
 
 template<class InputIter, class T>
 constexpr typename iterator_traits<InputIter>::difference_type
-count(InputIter first, InputIter last, const T &value) {
+_count_dispatch(InputIter first, InputIter last, const T &value, false_type) {
     using diff_t = typename iterator_traits<InputIter>::difference_type;
     diff_t n = 0;
     for (; first != last; ++first)
@@ -147,6 +221,30 @@ count(InputIter first, InputIter last, const T &value) {
     return n;
 }
 
+template<class InputIter, class T>
+constexpr typename iterator_traits<InputIter>::difference_type
+_count_dispatch(InputIter first, InputIter last, const T &value, true_type) {
+    using diff_t = typename iterator_traits<InputIter>::difference_type;
+    using V = _simd_value_t<InputIter>;
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_count_dispatch(first, last, value, false_type{});
+#endif
+    if (!ala::_simd_narrow<V>(value))
+        return 0;
+    const V *p = ala::to_address(first);
+    return static_cast<diff_t>(ala::intrin::simd_count(
+        p, p + (last - first), static_cast<V>(value)));
+}
+
+template<class InputIter, class T>
+constexpr typename iterator_traits<InputIter>::difference_type
+count(InputIter first, InputIter last, const T &value) {
+    using tag_t = _and_<_is_simd_iter<InputIter>,
+                        _is_simd_value<_simd_value_t<InputIter>, T>>;
+    return ala::_count_dispatch(first, last, value, tag_t{});
+}
+
 template<class InputIter, class UnaryPred>
 constexpr typename iterator_traits<InputIter>::difference_type
 count_if(InputIter first, InputIter last, UnaryPred pred) {
@@ -160,12 +258,38 @@ count_if(InputIter first, InputIter last, UnaryPred pred) {
 
 template<class InputIter1, class InputIter2, class BinPred>
 constexpr pair<InputIter1, InputIter2>
-mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, BinPred pred) {
+_mismatch_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                   BinPred pred, false_type) {
     while (first1 != last1 && pred(*first1, *first2))
         ++first1, (void)++first2;
     return ala::make_pair(first1, first2);
 }
 
+template<class InputIter1, class InputIter2, class BinPred>
+constexpr pair<InputIter1, InputIter2>
+_mismatch_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                   BinPred pred, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_mismatch_dispatch(first1, last1, first2, pred,
+                                       false_type{});
+#endif
+    size_t n = last1 - first1;
+    if (n == 0)
+        return ala::make_pair(first1, first2);
+    size_t i = ala::intrin::simd_mismatch<false>(ala::to_address(first1),
+                                                 ala::to_address(first2), n);
+    return ala::make_pair(first1 + i, first2 + i);
+}
+
+template<class InputIter1, class InputIter2, class BinPred>
+constexpr pair<InputIter1, InputIter2>
+mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, BinPred pred) {
+    using tag_t = _and_<_is_simd_iter2<InputIter1, InputIter2>,
+                        _is_simd_equal_to<BinPred, _simd_value_t<InputIter1>>>;
+    return ala::_mismatch_dispatch(first1, last1, first2, pred, tag_t{});
+}
+
 template<class InputIter1, class InputIter2>
 constexpr pair<InputIter1, InputIter2>
 mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2) {
@@ -174,13 +298,32 @@ mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2) {
 
 template<class InputIter1, class InputIter2, class BinPred>
 constexpr pair<InputIter1, InputIter2>
-mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2,
-         InputIter2 last2, BinPred pred) {
+_mismatch_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                   InputIter2 last2, BinPred pred, false_type) {
     while (first1 != last1 && first2 != last2 && pred(*first1, *first2))
         ++first1, (void)++first2;
     return ala::make_pair(first1, first2);
 }
 
+template<class InputIter1, class InputIter2, class BinPred>
+constexpr pair<InputIter1, InputIter2>
+_mismatch_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                   InputIter2 last2, BinPred pred, true_type) {
+    if (last2 - first2 < last1 - first1)
+        last1 = first1 + (last2 - first2);
+    return ala::_mismatch_dispatch(first1, last1, first2, pred, true_type{});
+}
+
+template<class InputIter1, class InputIter2, class BinPred>
+constexpr pair<InputIter1, InputIter2>
+mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+         InputIter2 last2, BinPred pred) {
+    using tag_t = _and_<_is_simd_iter2<InputIter1, InputIter2>,
+                        _is_simd_equal_to<BinPred, _simd_value_t<InputIter1>>>;
+    return ala::_mismatch_dispatch(first1, last1, first2, last2, pred,
+                                   tag_t{});
+}
+
 template<class InputIter1, class InputIter2>
 constexpr pair<InputIter1, InputIter2>
 mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2,
@@ -189,8 +332,9 @@ mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2,
 }
 
 template<class ForwardIter, class Size, class T, class BinPred>
-constexpr ForwardIter search_n(ForwardIter first, ForwardIter last, Size count,
-                               const T &value, BinPred pred) {
+constexpr ForwardIter _search_n_dispatch(ForwardIter first, ForwardIter last,
+                                         Size count, const T &value,
+                                         BinPred pred, false_type) {
     auto n = ala::_convert_to_integral(count);
     if (n < 1)
         return first;
@@ -213,6 +357,45 @@ constexpr ForwardIter search_n(ForwardIter first, ForwardIter last, Size count,
     return last;
 }
 
+template<class ForwardIter, class Size, class T, class BinPred>
+constexpr ForwardIter _search_n_dispatch(ForwardIter first, ForwardIter last,
+                                         Size count, const T &value,
+                                         BinPred pred, true_type) {
+    using V = _simd_value_t<ForwardIter>;
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_search_n_dispatch(first, last, count, value, pred,
+                                       false_type{});
+#endif
+    auto n = ala::_convert_to_integral(count);
+    if (n < 1)
+        return first;
+    if (!ala::_simd_narrow<V>(value))
+        return last;
+    const V v = static_cast<V>(value);
+    const V *begin = ala::to_address(first);
+    const V *end = begin + (last - first);
+    // find a candidate, then look for a breaker inside its window
+    for (const V *p = begin;;) {
+        p = ala::intrin::simd_find<true>(p, end, v);
+        if (static_cast<size_t>(end - p) < static_cast<size_t>(n))
+            return last;
+        const V *q = ala::intrin::simd_find<false>(p, p + n, v);
+        if (q == p + n)
+            return first + (p - begin);
+        p = q + 1;
+    }
+}
+
+template<class ForwardIter, class Size, class T, class BinPred>
+constexpr ForwardIter search_n(ForwardIter first, ForwardIter last, Size count,
+                               const T &value, BinPred pred) {
+    using tag_t = _and_<_is_simd_iter<ForwardIter>,
+                        _is_simd_value<_simd_value_t<ForwardIter>, T>,
+                        _is_simd_equal_to<BinPred, _simd_value_t<ForwardIter>>>;
+    return ala::_search_n_dispatch(first, last, count, value, pred, tag_t{});
+}
+
 template<class ForwardIter, class Size, class T>
 constexpr ForwardIter search_n(ForwardIter first, ForwardIter last, Size count,
                                const T &value) {
@@ -221,15 +404,39 @@ constexpr ForwardIter search_n(ForwardIter first, ForwardIter last, Size count,
 
 // Modifying sequence operations
 
-template<class InputIter, class OutputIter, class UnaryPred>
-constexpr OutputIter copy_if(InputIter first, InputIter last, OutputIter out,
-                             UnaryPred pred) {
+// copy_if and remove_copy_if, elements where pred(x) == Want
+template<bool Want, class InputIter, class OutputIter, class UnaryPred>
+constexpr OutputIter _copy_if_dispatch(InputIter first, InputIter last,
+                                       OutputIter out, UnaryPred &pred,
+                                       false_type) {
     for (; first != last; ++first)
-        if (pred(*first))
+        if (bool(pred(*first)) == Want)
             *out++ = *first;
     return out;
 }
 
+template<bool Want, class InputIter, class OutputIter, class UnaryPred>
+constexpr OutputIter _copy_if_dispatch(InputIter first, InputIter last,
+                                       OutputIter out, UnaryPred &pred,
+                                       true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_copy_if_dispatch<Want>(first, last, out, pred,
+                                            false_type{});
+#endif
+    auto o = ala::to_address(out);
+    auto q = ala::intrin::simd_compact_if<true, Want>(ala::to_address(first),
+                                                      last - first, o, pred);
+    return out + (q - o);
+}
+
+template<class InputIter, class OutputIter, class UnaryPred>
+constexpr OutputIter copy_if(InputIter first, InputIter last, OutputIter out,
+                             UnaryPred pred) {
+    using tag_t = _is_compact_iter2<InputIter, OutputIter>;
+    return ala::_copy_if_dispatch<true>(first, last, out, pred, tag_t{});
+}
+
 template<class InputIter, class OutputIter, class UnaryOperation>
 constexpr OutputIter transform(InputIter first, InputIter last, OutputIter out,
                                UnaryOperation unary_op) {
@@ -303,25 +510,53 @@ constexpr OutputIter generate_n(OutputIter first, Size count, Generator gen) {
 }
 
 template<class InputIter, class OutputIter, class T>
-constexpr OutputIter remove_copy(InputIter first, InputIter last,
-                                 OutputIter out, const T &value) {
+constexpr OutputIter _remove_copy_dispatch(InputIter first, InputIter last,
+                                           OutputIter out, const T &value,
+                                           false_type) {
     for (; first != last; ++first)
         if (!(*first == value))
             *out++ = *first;
     return out;
 }
 
+template<class InputIter, class OutputIter, class T>
+constexpr OutputIter _remove_copy_dispatch(InputIter first, InputIter last,
+                                           OutputIter out, const T &value,
+                                           true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_remove_copy_dispatch(first, last, out, value,
+                                          false_type{});
+#endif
+    using V = _simd_value_t<InputIter>;
+    if (!ala::_simd_narrow<V>(value))
+        return ala::copy(first, last, out);
+    auto o = ala::to_address(out);
+    auto q = ala::intrin::simd_compact_ne<true>(ala::to_address(first),
+                                                last - first, o,
+                                                static_cast<V>(value));
+    return out + (q - o);
+}
+
+template<class InputIter, class OutputIter, class T>
+constexpr OutputIter remove_copy(InputIter first, InputIter last,
+                                 OutputIter out, const T &value) {
+    using tag_t = _and_<_is_simd_compact<InputIter>,
+                        _is_compact_iter2<InputIter, OutputIter>,
+                        _is_simd_value<_simd_value_t<InputIter>, T>>;
+    return ala::_remove_copy_dispatch(first, last, out, value, tag_t{});
+}
+
 template<class InputIter, class OutputIter, class UnaryPred>
 constexpr OutputIter remove_copy_if(InputIter first, InputIter last,
                                     OutputIter out, UnaryPred pred) {
-    for (; first != last; ++first)
-        if (!pred(*first))
-            *out++ = *first;
-    return out;
+    using tag_t = _is_compact_iter2<InputIter, OutputIter>;
+    return ala::_copy_if_dispatch<false>(first, last, out, pred, tag_t{});
 }
 
 template<class ForwardIter, class BinPred>
-constexpr ForwardIter unique(ForwardIter first, ForwardIter last, BinPred pred) {
+constexpr ForwardIter _unique_dispatch(ForwardIter first, ForwardIter last,
+                                       BinPred &pred, false_type) {
     if (first == last)
         return last;
     for (ForwardIter next = first; ++next != last;)
@@ -330,6 +565,30 @@ constexpr ForwardIter unique(ForwardIter first, ForwardIter last, BinPred pred)
     return ++first;
 }
 
+template<class ForwardIter, class BinPred>
+constexpr ForwardIter _unique_dispatch(ForwardIter first, ForwardIter last,
+                                       BinPred &pred, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_unique_dispatch(first, last, pred, false_type{});
+#endif
+    first = ala::adjacent_find(first, last);
+    if (first == last)
+        return last;
+    auto p = ala::to_address(first) + 1;
+    auto q = ala::intrin::simd_compact_unique<false>(p + 1, last - first - 2,
+                                                     p);
+    return first + (q - p) + 1;
+}
+
+template<class ForwardIter, class BinPred>
+constexpr ForwardIter unique(ForwardIter first, ForwardIter last, BinPred pred) {
+    using tag_t =
+        _and_<_is_simd_compact<ForwardIter>,
+              _is_simd_equal_to<BinPred, _simd_value_t<ForwardIter>>>;
+    return ala::_unique_dispatch(first, last, pred, tag_t{});
+}
+
 template<class ForwardIter>
 constexpr ForwardIter unique(ForwardIter first, ForwardIter last) {
     return ala::unique(first, last, equal_to<>());
@@ -418,19 +677,24 @@ constexpr OutputIter rotate_copy(ForwardIter first, ForwardIter middle,
     return ala::copy(first, middle, ala::copy(middle, last, out));
 }
 
+// Fisher-Yates from the back. Once i * (i - 1) fits in 64 bits, one 64
+// bit word serves the indices of two steps.
 template<class RandomIter, class URBG>
 constexpr void shuffle(RandomIter first, RandomIter last, URBG &&g) {
     using diff_t = typename iterator_traits<RandomIter>::difference_type;
-    using ud_t = uniform_int_distribution<diff_t>;
-    using param_t = typename ud_t::param_type;
-    diff_t len = last - first;
-    if (len < 2)
-        return;
-    ud_t uid;
-    for (--last, (void)--len; first < last; ++first, (void)--len) {
-        diff_t offset = uid(g, param_t(0, len));
-        if (offset != diff_t(0))
-            ala::iter_swap(first, first + offset);
+    diff_t i = last - first;
+    for (; i > 1 && uint64_t(i) > 0xffffffffU; --i) {
+        diff_t r = static_cast<diff_t>(ala::_uniform_int(g, uint64_t(i - 1)));
+        if (r != i - 1)
+            ala::iter_swap(first + r, first + (i - 1));
+    }
+    for (; i > 1; i -= 2) {
+        uint64_t r1, r2;
+        ala::_bounded_rand2(g, uint64_t(i), uint64_t(i - 1), r1, r2);
+        if (diff_t(r1) != i - 1)
+            ala::iter_swap(first + diff_t(r1), first + (i - 1));
+        if (diff_t(r2) != i - 2)
+            ala::iter_swap(first + diff_t(r2), first + (i - 2));
     }
 }
 
@@ -528,8 +792,8 @@ constexpr BidirIter stable_partition(BidirIter first, BidirIter last,
 
 template<class InputIter, class OutputIter1, class OutputIter2, class UnaryPred>
 constexpr pair<OutputIter1, OutputIter2>
-partition_copy(InputIter first, InputIter last, OutputIter1 out_true,
-               OutputIter2 out_false, UnaryPred pred) {
+_partition_copy_dispatch(InputIter first, InputIter last, OutputIter1 out_true,
+                         OutputIter2 out_false, UnaryPred &pred, false_type) {
     for (; first != last; ++first)
         if (pred(*first))
             *out_true++ = *first;
@@ -538,6 +802,33 @@ partition_copy(InputIter first, InputIter last, OutputIter1 out_true,
     return ala::pair<OutputIter1, OutputIter2>(out_true, out_false);
 }
 
+template<class InputIter, class OutputIter1, class OutputIter2, class UnaryPred>
+constexpr pair<OutputIter1, OutputIter2>
+_partition_copy_dispatch(InputIter first, InputIter last, OutputIter1 out_true,
+                         OutputIter2 out_false, UnaryPred &pred, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_partition_copy_dispatch(first, last, out_true, out_false,
+                                             pred, false_type{});
+#endif
+    auto t = ala::to_address(out_true), f = ala::to_address(out_false);
+    auto t0 = t, f0 = f;
+    ala::intrin::simd_partition_copy(ala::to_address(first), last - first, t,
+                                     f, pred);
+    return ala::pair<OutputIter1, OutputIter2>(out_true + (t - t0),
+                                               out_false + (f - f0));
+}
+
+template<class InputIter, class OutputIter1, class OutputIter2, class UnaryPred>
+constexpr pair<OutputIter1, OutputIter2>
+partition_copy(InputIter first, InputIter last, OutputIter1 out_true,
+               OutputIter2 out_false, UnaryPred pred) {
+    using tag_t = _and_<_is_compact_iter2<InputIter, OutputIter1>,
+                        _is_compact_iter2<InputIter, OutputIter2>>;
+    return ala::_partition_copy_dispatch(first, last, out_true, out_false,
+                                         pred, tag_t{});
+}
+
 template<class ForwardIter, class UnaryPred>
 constexpr ForwardIter partition_point(ForwardIter first, ForwardIter last,
                                       UnaryPred pred) {
@@ -588,9 +879,43 @@ constexpr bool is_sorted(ForwardIter first, ForwardIter last) {
 }
 
 // Set operations (on sorted ranges)
+
+// Random access ranges whose sizes differ by more than the ratio walk the
+// smaller one and gallop through the other. The integer kernels of
+// ala::intrin skip runs a vector at a time, so they gallop only further apart.
+ALA_INLINE_CONSTEXPR_V size_t _gallop_ratio = 32;
+ALA_INLINE_CONSTEXPR_V size_t _simd_gallop_ratio = 512;
+
+template<class Iter1, class Iter2>
+struct _is_random_iter2
+    : _and_<is_base_of<random_access_iterator_tag, _iter_tag_t<Iter1>>,
+            is_base_of<random_access_iterator_tag, _iter_tag_t<Iter2>>> {};
+
+template<class Iter1, class Iter2, class OutputIter, class Comp>
+struct _is_simd_set
+    : _and_<_is_simd_iter2<Iter1, Iter2>, _is_simd_iter2<Iter1, OutputIter>,
+            is_integral<_simd_value_t<Iter1>>,
+            bool_constant<sizeof(_simd_value_t<Iter1>) == 4 ||
+                          sizeof(_simd_value_t<Iter1>) == 8>,
+            _is_simd_less<Comp, _simd_value_t<Iter1>>> {};
+
+// lower_bound probing 1, 2, 4... elements past first
+template<class RandomIter, class T, class Comp>
+constexpr RandomIter _gallop_lower(RandomIter first, RandomIter last,
+                                   const T &value, Comp comp) {
+    using diff_t = typename iterator_traits<RandomIter>::difference_type;
+    diff_t n = last - first, step = 1;
+    for (; step < n && comp(first[step - 1], value); step *= 2) {
+        first += step;
+        n -= step;
+    }
+    return ala::lower_bound(first, first + (step < n ? step : n), value, comp);
+}
+
 template<class InputIter1, class InputIter2, class Comp>
-constexpr bool includes(InputIter1 first1, InputIter1 last1, InputIter2 first2,
-                        InputIter2 last2, Comp comp) {
+constexpr bool _includes_dispatch(InputIter1 first1, InputIter1 last1,
+                                  InputIter2 first2, InputIter2 last2,
+                                  Comp comp, false_type) {
     for (; first2 != last2; ++first1) {
         if (first1 == last1 || comp(*first2, *first1))
             return false;
@@ -600,6 +925,55 @@ constexpr bool includes(InputIter1 first1, InputIter1 last1, InputIter2 first2,
     return true;
 }
 
+template<class RandomIter1, class RandomIter2, class Comp>
+constexpr bool _includes_simd(RandomIter1 first1, RandomIter1 last1,
+                              RandomIter2 first2, RandomIter2 last2, Comp comp,
+                              false_type) {
+    return ala::_includes_dispatch(first1, last1, first2, last2, comp,
+                                   false_type{});
+}
+
+template<class RandomIter1, class RandomIter2, class Comp>
+constexpr bool _includes_simd(RandomIter1 first1, RandomIter1 last1,
+                              RandomIter2 first2, RandomIter2 last2, Comp comp,
+                              true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_includes_dispatch(first1, last1, first2, last2, comp,
+                                       false_type{});
+#endif
+    return ala::intrin::simd_includes(ala::to_address(first1), last1 - first1,
+                                      ala::to_address(first2), last2 - first2);
+}
+
+template<class RandomIter1, class RandomIter2, class Comp>
+constexpr bool _includes_dispatch(RandomIter1 first1, RandomIter1 last1,
+                                  RandomIter2 first2, RandomIter2 last2,
+                                  Comp comp, true_type) {
+    using simd_t = _is_simd_set<RandomIter1, RandomIter2, RandomIter1, Comp>;
+    size_t n1 = last1 - first1, n2 = last2 - first2;
+    size_t ratio = simd_t::value ? _simd_gallop_ratio : _gallop_ratio;
+    if (n2 > n1)
+        return false;
+    if (n1 / ratio <= n2)
+        return ala::_includes_simd(first1, last1, first2, last2, comp,
+                                   simd_t{});
+    for (; first2 != last2; ++first1, (void)++first2) {
+        first1 = ala::_gallop_lower(first1, last1, *first2, comp);
+        if (first1 == last1 || comp(*first2, *first1))
+            return false;
+    }
+    return true;
+}
+
+template<class InputIter1, class InputIter2, class Comp>
+constexpr bool includes(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                        InputIter2 last2, Comp comp) {
+    using tag_t = _is_random_iter2<InputIter1, InputIter2>;
+    return ala::_includes_dispatch(first1, last1, first2, last2, comp,
+                                   tag_t{});
+}
+
 template<class InputIter1, class InputIter2>
 constexpr bool includes(InputIter1 first1, InputIter1 last1, InputIter2 first2,
                         InputIter2 last2) {
@@ -607,9 +981,10 @@ constexpr bool includes(InputIter1 first1, InputIter1 last1, InputIter2 first2,
 }
 
 template<class InputIter1, class InputIter2, class OutputIter, class Comp>
-constexpr OutputIter set_union(InputIter1 first1, InputIter1 last1,
-                               InputIter2 first2, InputIter2 last2,
-                               OutputIter out, Comp comp) {
+constexpr OutputIter _set_union_dispatch(InputIter1 first1, InputIter1 last1,
+                                         InputIter2 first2, InputIter2 last2,
+                                         OutputIter out, Comp comp,
+                                         false_type) {
     for (; first1 != last1; ++out) {
         if (first2 == last2)
             return ala::copy(first1, last1, out);
@@ -624,6 +999,75 @@ constexpr OutputIter set_union(InputIter1 first1, InputIter1 last1,
     return ala::copy(first2, last2, out);
 }
 
+template<class RandomIter1, class RandomIter2, class OutputIter, class Comp>
+constexpr OutputIter _set_union_simd(RandomIter1 first1, RandomIter1 last1,
+                                     RandomIter2 first2, RandomIter2 last2,
+                                     OutputIter out, Comp comp, false_type) {
+    return ala::_set_union_dispatch(first1, last1, first2, last2, out, comp,
+                                    false_type{});
+}
+
+template<class RandomIter1, class RandomIter2, class OutputIter, class Comp>
+constexpr OutputIter _set_union_simd(RandomIter1 first1, RandomIter1 last1,
+                                     RandomIter2 first2, RandomIter2 last2,
+                                     OutputIter out, Comp comp, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_set_union_dispatch(first1, last1, first2, last2, out,
+                                        comp, false_type{});
+#endif
+    auto p = ala::to_address(out);
+    return out + (ala::intrin::simd_set_union(ala::to_address(first1),
+                                              last1 - first1,
+                                              ala::to_address(first2),
+                                              last2 - first2, p) -
+                  p);
+}
+
+template<class RandomIter1, class RandomIter2, class OutputIter, class Comp>
+constexpr OutputIter _set_union_dispatch(RandomIter1 first1, RandomIter1 last1,
+                                         RandomIter2 first2, RandomIter2 last2,
+                                         OutputIter out, Comp comp,
+                                         true_type) {
+    using simd_t = _is_simd_set<RandomIter1, RandomIter2, OutputIter, Comp>;
+    size_t n1 = last1 - first1, n2 = last2 - first2;
+    size_t ratio = simd_t::value ? _simd_gallop_ratio : _gallop_ratio;
+    if (n1 / ratio > n2) {
+        for (; first2 != last2; ++first2, (void)++out) {
+            RandomIter1 mid = ala::_gallop_lower(first1, last1, *first2, comp);
+            out = ala::copy(first1, mid, out);
+            first1 = mid;
+            if (first1 != last1 && !comp(*first2, *first1))
+                *out = *first1++;
+            else
+                *out = *first2;
+        }
+        return ala::copy(first1, last1, out);
+    }
+    if (n2 / ratio > n1) {
+        for (; first1 != last1; ++first1, (void)++out) {
+            RandomIter2 mid = ala::_gallop_lower(first2, last2, *first1, comp);
+            out = ala::copy(first2, mid, out);
+            first2 = mid;
+            if (first2 != last2 && !comp(*first1, *first2))
+                ++first2;
+            *out = *first1;
+        }
+        return ala::copy(first2, last2, out);
+    }
+    return ala::_set_union_simd(first1, last1, first2, last2, out, comp,
+                                simd_t{});
+}
+
+template<class InputIter1, class InputIter2, class OutputIter, class Comp>
+constexpr OutputIter set_union(InputIter1 first1, InputIter1 last1,
+                               InputIter2 first2, InputIter2 last2,
+                               OutputIter out, Comp comp) {
+    using tag_t = _is_random_iter2<InputIter1, InputIter2>;
+    return ala::_set_union_dispatch(first1, last1, first2, last2, out, comp,
+                                    tag_t{});
+}
+
 template<class InputIter1, class InputIter2, class OutputIter>
 constexpr OutputIter set_union(InputIter1 first1, InputIter1 last1,
                                InputIter2 first2, InputIter2 last2,
@@ -632,9 +1076,10 @@ constexpr OutputIter set_union(InputIter1 first1, InputIter1 last1,
 }
 
 template<class InputIter1, class InputIter2, class OutputIter, class Comp>
-constexpr OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
-                                      InputIter2 first2, InputIter2 last2,
-                                      OutputIter out, Comp comp) {
+constexpr OutputIter
+_set_intersection_dispatch(InputIter1 first1, InputIter1 last1,
+                           InputIter2 first2, InputIter2 last2, OutputIter out,
+                           Comp comp, false_type) {
     while (first1 != last1 && first2 != last2) {
         if (comp(*first1, *first2)) {
             ++first1;
@@ -648,6 +1093,76 @@ constexpr OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
     return out;
 }
 
+template<class RandomIter1, class RandomIter2, class OutputIter, class Comp>
+constexpr OutputIter
+_set_intersection_simd(RandomIter1 first1, RandomIter1 last1,
+                       RandomIter2 first2, RandomIter2 last2, OutputIter out,
+                       Comp comp, false_type) {
+    return ala::_set_intersection_dispatch(first1, last1, first2, last2, out,
+                                           comp, false_type{});
+}
+
+template<class RandomIter1, class RandomIter2, class OutputIter, class Comp>
+constexpr OutputIter
+_set_intersection_simd(RandomIter1 first1, RandomIter1 last1,
+                       RandomIter2 first2, RandomIter2 last2, OutputIter out,
+                       Comp comp, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_set_intersection_dispatch(first1, last1, first2, last2,
+                                               out, comp, false_type{});
+#endif
+    auto p = ala::to_address(out);
+    return out + (ala::intrin::simd_set_intersection(ala::to_address(first1),
+                                                     last1 - first1,
+                                                     ala::to_address(first2),
+                                                     last2 - first2, p) -
+                  p);
+}
+
+template<class RandomIter1, class RandomIter2, class OutputIter, class Comp>
+constexpr OutputIter
+_set_intersection_dispatch(RandomIter1 first1, RandomIter1 last1,
+                           RandomIter2 first2, RandomIter2 last2,
+                           OutputIter out, Comp comp, true_type) {
+    using simd_t = _is_simd_set<RandomIter1, RandomIter2, OutputIter, Comp>;
+    size_t n1 = last1 - first1, n2 = last2 - first2;
+    size_t ratio = simd_t::value ? _simd_gallop_ratio : _gallop_ratio;
+    if (n1 / ratio > n2) {
+        for (; first2 != last2; ++first2) {
+            first1 = ala::_gallop_lower(first1, last1, *first2, comp);
+            if (first1 == last1)
+                break;
+            if (!comp(*first2, *first1))
+                *out++ = *first1++;
+        }
+        return out;
+    }
+    if (n2 / ratio > n1) {
+        for (; first1 != last1; ++first1) {
+            first2 = ala::_gallop_lower(first2, last2, *first1, comp);
+            if (first2 == last2)
+                break;
+            if (!comp(*first1, *first2)) {
+                *out++ = *first1;
+                ++first2;
+            }
+        }
+        return out;
+    }
+    return ala::_set_intersection_simd(first1, last1, first2, last2, out, comp,
+                                       simd_t{});
+}
+
+template<class InputIter1, class InputIter2, class OutputIter, class Comp>
+constexpr OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                                      InputIter2 first2, InputIter2 last2,
+                                      OutputIter out, Comp comp) {
+    using tag_t = _is_random_iter2<InputIter1, InputIter2>;
+    return ala::_set_intersection_dispatch(first1, last1, first2, last2, out,
+                                           comp, tag_t{});
+}
+
 template<class InputIter1, class InputIter2, class OutputIter>
 constexpr OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
                                       InputIter2 first2, InputIter2 last2,
@@ -656,9 +1171,10 @@ constexpr OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
 }
 
 template<class InputIter1, class InputIter2, class OutputIter, class Comp>
-constexpr OutputIter set_difference(InputIter1 first1, InputIter1 last1,
-                                    InputIter2 first2, InputIter2 last2,
-                                    OutputIter out, Comp comp) {
+constexpr OutputIter
+_set_difference_dispatch(InputIter1 first1, InputIter1 last1,
+                         InputIter2 first2, InputIter2 last2, OutputIter out,
+                         Comp comp, false_type) {
     while (first1 != last1) {
         if (first2 == last2)
             return ala::copy(first1, last1, out);
@@ -674,6 +1190,77 @@ constexpr OutputIter set_difference(InputIter1 first1, InputIter1 last1,
     return out;
 }
 
+template<class RandomIter1, class RandomIter2, class OutputIter, class Comp>
+constexpr OutputIter
+_set_difference_simd(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2,
+                     RandomIter2 last2, OutputIter out, Comp comp,
+                     false_type) {
+    return ala::_set_difference_dispatch(first1, last1, first2, last2, out,
+                                         comp, false_type{});
+}
+
+template<class RandomIter1, class RandomIter2, class OutputIter, class Comp>
+constexpr OutputIter
+_set_difference_simd(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2,
+                     RandomIter2 last2, OutputIter out, Comp comp, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_set_difference_dispatch(first1, last1, first2, last2, out,
+                                             comp, false_type{});
+#endif
+    auto p = ala::to_address(out);
+    return out + (ala::intrin::simd_set_difference(ala::to_address(first1),
+                                                   last1 - first1,
+                                                   ala::to_address(first2),
+                                                   last2 - first2, p) -
+                  p);
+}
+
+template<class RandomIter1, class RandomIter2, class OutputIter, class Comp>
+constexpr OutputIter
+_set_difference_dispatch(RandomIter1 first1, RandomIter1 last1,
+                         RandomIter2 first2, RandomIter2 last2, OutputIter out,
+                         Comp comp, true_type) {
+    using simd_t = _is_simd_set<RandomIter1, RandomIter2, OutputIter, Comp>;
+    size_t n1 = last1 - first1, n2 = last2 - first2;
+    size_t ratio = simd_t::value ? _simd_gallop_ratio : _gallop_ratio;
+    if (n1 / ratio > n2) {
+        for (; first2 != last2; ++first2) {
+            RandomIter1 mid = ala::_gallop_lower(first1, last1, *first2, comp);
+            out = ala::copy(first1, mid, out);
+            first1 = mid;
+            if (first1 == last1)
+                return out;
+            if (!comp(*first2, *first1))
+                ++first1;
+        }
+        return ala::copy(first1, last1, out);
+    }
+    if (n2 / ratio > n1) {
+        for (; first1 != last1; ++first1) {
+            first2 = ala::_gallop_lower(first2, last2, *first1, comp);
+            if (first2 == last2)
+                return ala::copy(first1, last1, out);
+            if (comp(*first1, *first2))
+                *out++ = *first1;
+            else
+                ++first2;
+        }
+        return out;
+    }
+    return ala::_set_difference_simd(first1, last1, first2, last2, out, comp,
+                                     simd_t{});
+}
+
+template<class InputIter1, class InputIter2, class OutputIter, class Comp>
+constexpr OutputIter set_difference(InputIter1 first1, InputIter1 last1,
+                                    InputIter2 first2, InputIter2 last2,
+                                    OutputIter out, Comp comp) {
+    using tag_t = _is_random_iter2<InputIter1, InputIter2>;
+    return ala::_set_difference_dispatch(first1, last1, first2, last2, out,
+                                         comp, tag_t{});
+}
+
 template<class InputIter1, class InputIter2, class OutputIter>
 constexpr OutputIter set_difference(InputIter1 first1, InputIter1 last1,
                                     InputIter2 first2, InputIter2 last2,
@@ -722,9 +1309,8 @@ constexpr pair<const T &, const T &> minmax(const T &a, const T &b) {
 }
 
 template<class ForwardIter, class Comp>
-constexpr ForwardIter min_element(ForwardIter first, ForwardIter last, Comp comp) {
-    static_assert(is_base_of<forward_iterator_tag, _iter_tag_t<ForwardIter>>::value,
-                  "ala::min_element need Forward Iterator");
+constexpr ForwardIter _min_element_dispatch(ForwardIter first, ForwardIter last,
+                                            Comp comp, false_type) {
     if (first == last)
         return last;
     ForwardIter min = first;
@@ -735,15 +1321,37 @@ constexpr ForwardIter min_element(ForwardIter first, ForwardIter last, Comp comp
     return min;
 }
 
+template<class ForwardIter, class Comp>
+constexpr ForwardIter _min_element_dispatch(ForwardIter first, ForwardIter last,
+                                            Comp comp, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_min_element_dispatch(first, last, comp, false_type{});
+#endif
+    size_t n = last - first, lo = 0, hi = 0;
+    if (n != 0 && ala::intrin::simd_extremum<true, false, false>(
+                      ala::to_address(first), n, lo, hi))
+        return first + lo;
+    return ala::_min_element_dispatch(first, last, comp, false_type{});
+}
+
+template<class ForwardIter, class Comp>
+constexpr ForwardIter min_element(ForwardIter first, ForwardIter last, Comp comp) {
+    static_assert(is_base_of<forward_iterator_tag, _iter_tag_t<ForwardIter>>::value,
+                  "ala::min_element need Forward Iterator");
+    using tag_t = _and_<_is_simd_iter<ForwardIter>,
+                        _is_simd_less<Comp, _simd_value_t<ForwardIter>>>;
+    return ala::_min_element_dispatch(first, last, comp, tag_t{});
+}
+
 template<class ForwardIter>
 constexpr ForwardIter min_element(ForwardIter first, ForwardIter last) {
     return ala::min_element(first, last, less<>());
 }
 
 template<class ForwardIter, class Comp>
-constexpr ForwardIter max_element(ForwardIter first, ForwardIter last, Comp comp) {
-    static_assert(is_base_of<forward_iterator_tag, _iter_tag_t<ForwardIter>>::value,
-                  "ala::max_element need Forward Iterator");
+constexpr ForwardIter _max_element_dispatch(ForwardIter first, ForwardIter last,
+                                            Comp comp, false_type) {
     if (first == last)
         return last;
     ForwardIter max = first;
@@ -754,6 +1362,29 @@ constexpr ForwardIter max_element(ForwardIter first, ForwardIter last, Comp comp
     return max;
 }
 
+template<class ForwardIter, class Comp>
+constexpr ForwardIter _max_element_dispatch(ForwardIter first, ForwardIter last,
+                                            Comp comp, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_max_element_dispatch(first, last, comp, false_type{});
+#endif
+    size_t n = last - first, lo = 0, hi = 0;
+    if (n != 0 && ala::intrin::simd_extremum<false, true, false>(
+                      ala::to_address(first), n, lo, hi))
+        return first + hi;
+    return ala::_max_element_dispatch(first, last, comp, false_type{});
+}
+
+template<class ForwardIter, class Comp>
+constexpr ForwardIter max_element(ForwardIter first, ForwardIter last, Comp comp) {
+    static_assert(is_base_of<forward_iterator_tag, _iter_tag_t<ForwardIter>>::value,
+                  "ala::max_element need Forward Iterator");
+    using tag_t = _and_<_is_simd_iter<ForwardIter>,
+                        _is_simd_less<Comp, _simd_value_t<ForwardIter>>>;
+    return ala::_max_element_dispatch(first, last, comp, tag_t{});
+}
+
 template<class ForwardIter>
 constexpr ForwardIter max_element(ForwardIter first, ForwardIter last) {
     return ala::max_element(first, last, less<>());
@@ -761,9 +1392,8 @@ constexpr ForwardIter max_element(ForwardIter first, ForwardIter last) {
 
 template<class ForwardIter, class Comp>
 constexpr pair<ForwardIter, ForwardIter>
-minmax_element(ForwardIter first, ForwardIter last, Comp comp) {
-    static_assert(is_base_of<forward_iterator_tag, _iter_tag_t<ForwardIter>>::value,
-                  "ala::minmax_element need Forward Iterator");
+_minmax_element_dispatch(ForwardIter first, ForwardIter last, Comp comp,
+                         false_type) {
     if (first == last)
         return pair<ForwardIter, ForwardIter>(last, last);
     ForwardIter min = first;
@@ -792,12 +1422,116 @@ minmax_element(ForwardIter first, ForwardIter last, Comp comp) {
     return ala::make_pair(min, max);
 }
 
+template<class ForwardIter, class Comp>
+constexpr pair<ForwardIter, ForwardIter>
+_minmax_element_dispatch(ForwardIter first, ForwardIter last, Comp comp,
+                         true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_minmax_element_dispatch(first, last, comp, false_type{});
+#endif
+    size_t n = last - first, lo = 0, hi = 0;
+    if (n != 0 && ala::intrin::simd_extremum<true, true, true>(
+                      ala::to_address(first), n, lo, hi))
+        return ala::make_pair(first + lo, first + hi);
+    return ala::_minmax_element_dispatch(first, last, comp, false_type{});
+}
+
+template<class ForwardIter, class Comp>
+constexpr pair<ForwardIter, ForwardIter>
+minmax_element(ForwardIter first, ForwardIter last, Comp comp) {
+    static_assert(is_base_of<forward_iterator_tag, _iter_tag_t<ForwardIter>>::value,
+                  "ala::minmax_element need Forward Iterator");
+    using tag_t = _and_<_is_simd_iter<ForwardIter>,
+                        _is_simd_less<Comp, _simd_value_t<ForwardIter>>>;
+    return ala::_minmax_element_dispatch(first, last, comp, tag_t{});
+}
+
 template<class ForwardIter>
 constexpr pair<ForwardIter, ForwardIter> minmax_element(ForwardIter first,
                                                         ForwardIter last) {
     return ala::minmax_element(first, last, less<>());
 }
 
+// Value-only reductions, the range must not be empty
+template<class InputIter, class Comp>
+constexpr typename iterator_traits<InputIter>::value_type
+_min_value_dispatch(InputIter first, InputIter last, Comp comp, false_type) {
+    typename iterator_traits<InputIter>::value_type v = *first;
+    for (++first; first != last; ++first)
+        if (comp(*first, v))
+            v = *first;
+    return v;
+}
+
+template<class InputIter, class Comp>
+constexpr typename iterator_traits<InputIter>::value_type
+_min_value_dispatch(InputIter first, InputIter last, Comp comp, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_min_value_dispatch(first, last, comp, false_type{});
+#endif
+    _simd_value_t<InputIter> v{};
+    if (ala::intrin::simd_extremum_value<false>(ala::to_address(first),
+                                                last - first, v))
+        return v;
+    return ala::_min_value_dispatch(first, last, comp, false_type{});
+}
+
+template<class InputIter, class Comp>
+constexpr typename iterator_traits<InputIter>::value_type
+min_value(InputIter first, InputIter last, Comp comp) {
+    assert(first != last);
+    using tag_t = _and_<_is_simd_iter<InputIter>,
+                        _is_simd_less<Comp, _simd_value_t<InputIter>>>;
+    return ala::_min_value_dispatch(first, last, comp, tag_t{});
+}
+
+template<class InputIter>
+constexpr typename iterator_traits<InputIter>::value_type
+min_value(InputIter first, InputIter last) {
+    return ala::min_value(first, last, less<>());
+}
+
+template<class InputIter, class Comp>
+constexpr typename iterator_traits<InputIter>::value_type
+_max_value_dispatch(InputIter first, InputIter last, Comp comp, false_type) {
+    typename iterator_traits<InputIter>::value_type v = *first;
+    for (++first; first != last; ++first)
+        if (comp(v, *first))
+            v = *first;
+    return v;
+}
+
+template<class InputIter, class Comp>
+constexpr typename iterator_traits<InputIter>::value_type
+_max_value_dispatch(InputIter first, InputIter last, Comp comp, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_max_value_dispatch(first, last, comp, false_type{});
+#endif
+    _simd_value_t<InputIter> v{};
+    if (ala::intrin::simd_extremum_value<true>(ala::to_address(first),
+                                               last - first, v))
+        return v;
+    return ala::_max_value_dispatch(first, last, comp, false_type{});
+}
+
+template<class InputIter, class Comp>
+constexpr typename iterator_traits<InputIter>::value_type
+max_value(InputIter first, InputIter last, Comp comp) {
+    assert(first != last);
+    using tag_t = _and_<_is_simd_iter<InputIter>,
+                        _is_simd_less<Comp, _simd_value_t<InputIter>>>;
+    return ala::_max_value_dispatch(first, last, comp, tag_t{});
+}
+
+template<class InputIter>
+constexpr typename iterator_traits<InputIter>::value_type
+max_value(InputIter first, InputIter last) {
+    return ala::max_value(first, last, less<>());
+}
+
 template<class T, class Comp>
 constexpr T min(initializer_list<T> t, Comp comp) {
     return *ala::min_element(t.begin(), t.end(), comp);
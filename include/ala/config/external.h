@@ -21,6 +21,7 @@ using ::std::initializer_list;
 using ::std::memmove;
 using ::std::memcpy;
 using ::std::memset;
+using ::std::memcmp;
 
 using ::std::nullptr_t;
 
@@ -152,6 +152,14 @@
     #endif
 #endif
 
+#if !defined(ALA_PREFETCH)
+    #if ALA_HAS_BUILTIN(__builtin_prefetch) || defined(_ALA_GCC)
+        #define ALA_PREFETCH(p) __builtin_prefetch(p)
+    #else
+        #define ALA_PREFETCH(p) ((void)(p))
+    #endif
+#endif
+
 #if defined(_ALA_MSVC) || defined(_ALA_CLANG_MSVC)
     #define ALA_INLINE __inline
     #define ALA_FORCEINLINE __forceinline
@@ -183,6 +191,10 @@
     #define ALA_TEMPLATE_RECURSIVE_DEPTH 512
 #endif
 
+#ifndef ALA_USE_SIMD
+    #define ALA_USE_SIMD 1
+#endif
+
 #if (__cpp_inline_variables >= 201606L || \
      (defined(_ALA_MSVC) && _MSC_VER >= 1912)) && \
     ALA_LANG >= 201703L
@@ -1,13 +1,703 @@
 #ifndef _ALA_DEQUE_H
 #define _ALA_DEQUE_H
 
-#include <ala/ring.h>
+#include <ala/segmented_vector.h>
 
 namespace ala {
 
+// log2 of the elements in a block, blocks of about 4 KiB and at least 16
+// elements
+template<class T>
+struct _deque_shift: _log2_floor<(sizeof(T) >= 256 ? 16 : 4096 / sizeof(T))> {};
+
+// Elements in fixed blocks reached through a map of block pointers. The
+// element at position p lives in _map[p >> _shift] at p & _mask, positions
+// of the elements are [_start, _start + size()). Pushing at either end adds
+// a block or moves block pointers inside the map, elements never move and
+// references stay valid until the element is erased. Iterators hold the
+// map and are invalidated by insertion. A map slot is non-null exactly
+// when its block holds an element, one emptied block is kept in _spare so
+// push and pop across a block boundary do not allocate every time.
 template<class T, class Alloc = allocator<T>>
-using deque = ring<T, Alloc>;
+class deque {
+public:
+    // types:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using _alloc_traits = allocator_traits<allocator_type>;
+    using size_type = typename _alloc_traits::size_type;
+    using difference_type = typename _alloc_traits::difference_type;
+    using pointer = typename _alloc_traits::pointer;
+    using const_pointer = typename _alloc_traits::const_pointer;
+    using iterator = segmented_vector_iterator<value_type, deque>;
+    using const_iterator = segmented_vector_iterator<const value_type, deque>;
+    using reverse_iterator = ala::reverse_iterator<iterator>;
+    using const_reverse_iterator = ala::reverse_iterator<const_iterator>;
+    static_assert(is_same<value_type, typename _alloc_traits::value_type>::value,
+                  "allocator::value_type mismatch");
+    static_assert(is_pointer<pointer>::value,
+                  "block map needs an allocator of raw pointers");
+
+    static constexpr size_type _shift = _deque_shift<T>::value;
+    static constexpr size_type block_size = size_type(1) << _shift;
+    static constexpr size_type _mask = block_size - 1;
+
+protected:
+    using _map_alloc = typename _alloc_traits::template rebind_alloc<pointer>;
+    using _map_t = vector<pointer, _map_alloc>;
+
+    allocator_type _alloc;
+    _map_t _map;
+    size_type _start = 0;
+    size_type _size = 0;
+    pointer _spare = nullptr;
+
+    pointer _at(size_type i) const noexcept {
+        size_type p = _start + i;
+        return _map[p >> _shift] + (p & _mask);
+    }
+
+    pointer acquire() {
+        if (_spare != nullptr) {
+            pointer blk = _spare;
+            _spare = nullptr;
+            return blk;
+        }
+        return _alloc.allocate(block_size);
+    }
+
+    // empties a map slot, the block is kept as the spare or given back
+    void release(pointer &blk) noexcept {
+        if (_spare == nullptr)
+            _spare = blk;
+        else
+            _alloc.deallocate(blk, block_size);
+        blk = nullptr;
+    }
+
+    size_type first_block() const noexcept {
+        return _start >> _shift;
+    }
+
+    // blocks holding elements, from first_block()
+    size_type used_blocks() const noexcept {
+        if (_size == 0)
+            return 0;
+        return ((_start + _size - 1) >> _shift) - first_block() + 1;
+    }
+
+    // Makes a free slot before the first block (front) or after the last,
+    // centering the used slots and doubling the map when more than half of
+    // it is in use. The slots moved are proportional to the pushes since
+    // the last remap, amortized O(1).
+    void remap() {
+        size_type used = this->used_blocks(), first = this->first_block();
+        size_type n = _map.size();
+        size_type want = 2 * used + 2 > 8 ? 2 * used + 2 : 8;
+        size_type dest = ((n < want ? want : n) - used) / 2;
+        if (n < want) {
+            _map_t map(want, nullptr, _map_alloc(_alloc));
+            ala::copy(_map.begin() + first, _map.begin() + first + used,
+                      map.begin() + dest);
+            _map.swap(map);
+        } else if (dest < first) {
+            ala::copy(_map.begin() + first, _map.begin() + first + used,
+                      _map.begin() + dest);
+            ala::fill(_map.begin() + ala::max(dest + used, first),
+                      _map.begin() + first + used, nullptr);
+        } else if (dest > first) {
+            ala::copy_backward(_map.begin() + first,
+                               _map.begin() + first + used,
+                               _map.begin() + dest + used);
+            ala::fill(_map.begin() + first,
+                      _map.begin() + ala::min(dest, first + used), nullptr);
+        }
+        _start = (dest << _shift) + (_start & _mask);
+    }
+
+    // slot of the position before begin(), made free if needed
+    pointer &front_slot() {
+        if (_start == 0)
+            this->remap();
+        return _map[(_start - 1) >> _shift];
+    }
+
+    // slot of the position at end(), made free if needed
+    pointer &back_slot() {
+        if (((_start + _size) >> _shift) >= _map.size())
+            this->remap();
+        return _map[(_start + _size) >> _shift];
+    }
+
+    void free_blocks() noexcept {
+        for (pointer &blk : _map)
+            if (blk != nullptr)
+                this->release(blk);
+        if (_spare != nullptr)
+            _alloc.deallocate(_spare, block_size);
+        _spare = nullptr;
+    }
+
+    void destroy() noexcept {
+        clear();
+        this->free_blocks();
+        _map.clear();
+        _map.shrink_to_fit();
+        _start = 0;
+    }
+
+    template<class... V>
+    void v_append(size_type n, V &&...v) {
+        size_type sz = size();
+        try {
+            for (; n > 0; --n)
+                this->emplace_back(ala::forward<V>(v)...);
+        } catch (...) {
+            this->cut(sz);
+            throw;
+        }
+    }
+
+    template<class InputIter>
+    void append(InputIter first, InputIter last) {
+        size_type sz = size();
+        try {
+            for (; first != last; ++first)
+                this->emplace_back(*first);
+        } catch (...) {
+            this->cut(sz);
+            throw;
+        }
+    }
+
+    // pops from the back down to n elements
+    void cut(size_type n) noexcept {
+        while (_size > n)
+            pop_back();
+    }
+
+    // pops n elements from the front
+    void cut_front(size_type n) noexcept {
+        for (; n > 0; --n)
+            pop_front();
+    }
+
+    void possess(deque &&other) noexcept {
+        _map = ala::move(other._map);
+        _start = other._start;
+        _size = other._size;
+        _spare = other._spare;
+        other._start = other._size = 0;
+        other._spare = nullptr;
+    }
+
+public:
+    // construct/copy/destroy:
+    deque() noexcept(is_nothrow_default_constructible<allocator_type>::value)
+        : _map(_map_alloc(_alloc)) {}
+
+    explicit deque(const allocator_type &a) noexcept
+        : _alloc(a), _map(_map_alloc(_alloc)) {}
+
+    explicit deque(size_type n, const allocator_type &a = allocator_type())
+        : deque(a) {
+        this->v_append(n);
+    }
+
+    deque(size_type n, const value_type &v,
+          const allocator_type &a = allocator_type())
+        : deque(a) {
+        this->v_append(n, v);
+    }
+
+    template<class InputIter,
+             typename = enable_if_t<
+                 is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value>>
+    deque(InputIter first, InputIter last,
+          const allocator_type &a = allocator_type())
+        : deque(a) {
+        this->append(first, last);
+    }
+
+    deque(const deque &other)
+        : deque(_alloc_traits::select_on_container_copy_construction(
+              other._alloc)) {
+        this->append(other.begin(), other.end());
+    }
+
+    deque(deque &&other) noexcept
+        : _alloc(ala::move(other._alloc)), _map(ala::move(other._map)),
+          _start(other._start), _size(other._size), _spare(other._spare) {
+        other._start = other._size = 0;
+        other._spare = nullptr;
+    }
+
+    deque(const deque &other, const type_identity_t<allocator_type> &a)
+        : deque(a) {
+        this->append(other.begin(), other.end());
+    }
+
+    deque(deque &&other, const type_identity_t<allocator_type> &a)
+        : deque(a) {
+        if (_alloc == other._alloc)
+            this->possess(ala::move(other));
+        else
+            this->append(ala::make_move_iterator(other.begin()),
+                         ala::make_move_iterator(other.end()));
+    }
+
+    deque(initializer_list<value_type> il,
+          const allocator_type &a = allocator_type())
+        : deque(il.begin(), il.end(), a) {}
+
+    ~deque() {
+        destroy();
+    }
+
+protected:
+    template<bool Dummy = _alloc_traits::propagate_on_container_copy_assignment::value>
+    enable_if_t<Dummy> copy_helper(const deque &other) {
+        if (_alloc != other._alloc) {
+            destroy();
+            _alloc = other._alloc;
+            _map = _map_t(_map_alloc(_alloc));
+        }
+        this->assign(other.begin(), other.end());
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_copy_assignment::value>
+    enable_if_t<!Dummy> copy_helper(const deque &other) {
+        this->assign(other.begin(), other.end());
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_move_assignment::value>
+    enable_if_t<Dummy> move_helper(deque &&other) {
+        destroy();
+        _alloc = ala::move(other._alloc);
+        this->possess(ala::move(other));
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_move_assignment::value>
+    enable_if_t<!Dummy> move_helper(deque &&other) {
+        if (_alloc == other._alloc) {
+            destroy();
+            this->possess(ala::move(other));
+        } else {
+            this->assign(ala::make_move_iterator(other.begin()),
+                         ala::make_move_iterator(other.end()));
+        }
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_swap::value>
+    enable_if_t<Dummy> swap_helper(deque &other) noexcept {
+        ala::_swap_adl(_alloc, other._alloc);
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_swap::value>
+    enable_if_t<!Dummy> swap_helper(deque &other) noexcept {
+        assert(_alloc == other._alloc);
+    }
+
+public:
+    deque &operator=(const deque &other) {
+        if (this != ala::addressof(other))
+            copy_helper(other);
+        return *this;
+    }
+
+    deque &operator=(deque &&other) noexcept(
+        _alloc_traits::propagate_on_container_move_assignment::value ||
+        _alloc_traits::is_always_equal::value) {
+        if (this != ala::addressof(other))
+            move_helper(ala::move(other));
+        return *this;
+    }
+
+    deque &operator=(initializer_list<value_type> il) {
+        this->assign(il.begin(), il.end());
+        return *this;
+    }
+
+    void swap(deque &other) noexcept(
+        _alloc_traits::propagate_on_container_swap::value ||
+        _alloc_traits::is_always_equal::value) {
+        this->swap_helper(other);
+        _map.swap(other._map);
+        ala::swap(_start, other._start);
+        ala::swap(_size, other._size);
+        ala::swap(_spare, other._spare);
+    }
+
+    template<class InputIter>
+    enable_if_t<is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value>
+    assign(InputIter first, InputIter last) {
+        size_type i = 0;
+        for (; first != last && i < size(); ++first, (void)++i)
+            *this->_at(i) = *first;
+        if (i < size())
+            this->cut(i);
+        this->append(first, last);
+    }
+
+    void assign(size_type n, const value_type &v) {
+        size_type i = 0;
+        for (; n > 0 && i != size(); --n, (void)++i)
+            *this->_at(i) = v;
+        if (i != size())
+            this->cut(i);
+        this->v_append(n, v);
+    }
+
+    void assign(initializer_list<value_type> il) {
+        this->assign(il.begin(), il.end());
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return _alloc;
+    }
+
+    // iterator:
+    iterator begin() noexcept {
+        return iterator(_map.data(), _start);
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    iterator end() noexcept {
+        return iterator(_map.data(), _start + _size);
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return crbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return crend();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_iterator(_map.data(), _start);
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator(_map.data(), _start + _size);
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(cend());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(cbegin());
+    }
+
+    // capacity:
+    size_type size() const noexcept {
+        return _size;
+    }
+
+    size_type max_size() const noexcept {
+        return _alloc_traits::max_size(_alloc);
+    }
+
+    void resize(size_type n) {
+        if (size() > n)
+            this->cut(n);
+        else
+            this->v_append(n - size());
+    }
+
+    void resize(size_type n, const value_type &v) {
+        if (size() > n)
+            this->cut(n);
+        else
+            this->v_append(n - size(), v);
+    }
+
+    ALA_NODISCARD bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    void shrink_to_fit() {
+        if (_spare != nullptr)
+            _alloc.deallocate(_spare, block_size);
+        _spare = nullptr;
+        if (empty()) {
+            _map.clear();
+            _start = 0;
+        }
+        _map.shrink_to_fit();
+    }
+
+    // element access:
+    reference operator[](size_type n) {
+        return *this->_at(n);
+    }
+
+    const_reference operator[](size_type n) const {
+        return *this->_at(n);
+    }
+
+    reference at(size_type n) {
+        if (!(n < size()))
+            throw out_of_range("ala::deque index out of range");
+        return *this->_at(n);
+    }
+
+    const_reference at(size_type n) const {
+        if (!(n < size()))
+            throw out_of_range("ala::deque index out of range");
+        return *this->_at(n);
+    }
+
+    reference front() {
+        return *this->_at(0);
+    }
+
+    const_reference front() const {
+        return *this->_at(0);
+    }
+
+    reference back() {
+        return *this->_at(_size - 1);
+    }
+
+    const_reference back() const {
+        return *this->_at(_size - 1);
+    }
+
+    // modifiers:
+    template<class... Args>
+    reference emplace_front(Args &&...args) {
+        pointer &blk = this->front_slot();
+        bool fresh = blk == nullptr;
+        if (fresh)
+            blk = this->acquire();
+        pointer p = blk + ((_start - 1) & _mask);
+        try {
+            _alloc_traits::construct(_alloc, p, ala::forward<Args>(args)...);
+        } catch (...) {
+            if (fresh)
+                this->release(blk);
+            throw;
+        }
+        --_start;
+        ++_size;
+        return *p;
+    }
+
+    template<class... Args>
+    reference emplace_back(Args &&...args) {
+        pointer &blk = this->back_slot();
+        bool fresh = blk == nullptr;
+        if (fresh)
+            blk = this->acquire();
+        pointer p = blk + ((_start + _size) & _mask);
+        try {
+            _alloc_traits::construct(_alloc, p, ala::forward<Args>(args)...);
+        } catch (...) {
+            if (fresh)
+                this->release(blk);
+            throw;
+        }
+        ++_size;
+        return *p;
+    }
+
+    void push_front(const value_type &v) {
+        this->emplace_front(v);
+    }
+
+    void push_front(value_type &&v) {
+        this->emplace_front(ala::move(v));
+    }
+
+    void push_back(const value_type &v) {
+        this->emplace_back(v);
+    }
+
+    void push_back(value_type &&v) {
+        this->emplace_back(ala::move(v));
+    }
+
+    void pop_front() {
+        size_type p = _start;
+        pointer &blk = _map[p >> _shift];
+        _alloc_traits::destroy(_alloc, blk + (p & _mask));
+        ++_start;
+        --_size;
+        if ((_start & _mask) == 0 || _size == 0)
+            this->release(blk);
+    }
+
+    void pop_back() {
+        size_type p = _start + _size - 1;
+        pointer &blk = _map[p >> _shift];
+        _alloc_traits::destroy(_alloc, blk + (p & _mask));
+        --_size;
+        if ((p & _mask) == 0 || _size == 0)
+            this->release(blk);
+    }
+
+    // shifts the shorter side, as std::deque
+    template<class... Args>
+    iterator emplace(const_iterator position, Args &&...args) {
+        difference_type offset = position - cbegin();
+        if ((size_type)offset < size() / 2) {
+            this->emplace_front(ala::forward<Args>(args)...);
+            ala::rotate(begin(), begin() + 1, begin() + offset + 1);
+        } else {
+            this->emplace_back(ala::forward<Args>(args)...);
+            ala::rotate(begin() + offset, end() - 1, end());
+        }
+        return begin() + offset;
+    }
+
+    iterator insert(const_iterator position, const value_type &v) {
+        return this->emplace(position, v);
+    }
+
+    iterator insert(const_iterator position, value_type &&v) {
+        return this->emplace(position, ala::move(v));
+    }
+
+    iterator insert(const_iterator position, size_type n, const value_type &v) {
+        difference_type offset = position - cbegin();
+        if ((size_type)offset < size() / 2) {
+            size_type i = 0;
+            try {
+                for (; i < n; ++i)
+                    this->emplace_front(v);
+            } catch (...) {
+                this->cut_front(i);
+                throw;
+            }
+            ala::rotate(begin(), begin() + n, begin() + offset + n);
+        } else {
+            this->v_append(n, v);
+            ala::rotate(begin() + offset, end() - n, end());
+        }
+        return begin() + offset;
+    }
+
+    template<class InputIter>
+    enable_if_t<is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value,
+                iterator>
+    insert(const_iterator position, InputIter first, InputIter last) {
+        difference_type offset = position - cbegin();
+        size_type sz = size();
+        this->append(first, last);
+        ala::rotate(begin() + offset, begin() + sz, end());
+        return begin() + offset;
+    }
+
+    iterator insert(const_iterator position, initializer_list<value_type> il) {
+        return this->insert(position, il.begin(), il.end());
+    }
+
+    iterator erase(const_iterator position) {
+        return this->erase(position, position + 1);
+    }
+
+    // shifts the shorter side, as std::deque
+    iterator erase(const_iterator first, const_iterator last) {
+        difference_type offset = first - cbegin();
+        difference_type n = last - first;
+        if (n == 0)
+            return begin() + offset;
+        if ((size_type)offset < (size() - n) / 2) {
+            ala::move_backward(begin(), begin() + offset, begin() + offset + n);
+            this->cut_front(n);
+        } else {
+            ala::move(begin() + offset + n, end(), begin() + offset);
+            this->cut(size() - n);
+        }
+        return begin() + offset;
+    }
+
+    void clear() noexcept {
+        this->cut(0);
+    }
+};
+
+template<class T, class Alloc>
+constexpr typename deque<T, Alloc>::size_type deque<T, Alloc>::block_size;
+
+template<class T, class Alloc>
+bool operator==(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
+    if (lhs.size() == rhs.size())
+        return ala::equal(lhs.begin(), lhs.end(), rhs.begin());
+    return false;
+}
+
+template<class T, class Alloc>
+bool operator!=(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
+    return !(lhs == rhs);
+}
+
+template<class T, class Alloc>
+bool operator<(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
+    return ala::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                        rhs.end());
+}
+
+template<class T, class Alloc>
+bool operator>(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
+    return rhs < lhs;
+}
+
+template<class T, class Alloc>
+bool operator<=(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
+    return !(rhs < lhs);
+}
+
+template<class T, class Alloc>
+bool operator>=(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
+    return !(lhs < rhs);
+}
+
+template<class T, class Alloc>
+void swap(deque<T, Alloc> &lhs,
+          deque<T, Alloc> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template<class T, class Alloc, class U>
+typename deque<T, Alloc>::size_type erase(deque<T, Alloc> &c, const U &value) {
+    using iter_t = typename deque<T, Alloc>::iterator;
+    using diff_t = typename deque<T, Alloc>::difference_type;
+    iter_t i = ala::remove(c.begin(), c.end(), value);
+    diff_t n = ala::distance(i, c.end());
+    c.erase(i, c.end());
+    return n;
+}
+
+template<class T, class Alloc, class Pred>
+typename deque<T, Alloc>::size_type erase_if(deque<T, Alloc> &c, Pred pred) {
+    using iter_t = typename deque<T, Alloc>::iterator;
+    using diff_t = typename deque<T, Alloc>::difference_type;
+    iter_t i = ala::remove_if(c.begin(), c.end(), pred);
+    diff_t n = ala::distance(i, c.end());
+    c.erase(i, c.end());
+    return n;
+}
 
 } // namespace ala
 
-#endif
\ No newline at end of file
+#endif // HEAD
@@ -4,9 +4,76 @@
 #include <ala/detail/functional_base.h>
 #include <ala/detail/pair.h>
 #include <ala/iterator.h>
+#include <ala/detail/uninitialized_memory.h>
+#include <ala/detail/simd/find.h>
+#include <ala/detail/simd/compact.h>
 
 namespace ala {
 
+// Contiguous ranges of arithmetic values are handed to ala::intrin kernels
+template<class Iter, class Ref = typename iterator_traits<Iter>::reference,
+         class T = remove_cv_t<remove_reference_t<Ref>>>
+struct _is_simd_iter
+    : bool_constant<ALA_USE_SIMD &&
+                    (is_pointer<Iter>::value ||
+                     is_base_of<contiguous_iterator_tag,
+                                _iter_concept_t<Iter>>::value) &&
+                    is_lvalue_reference<Ref>::value &&
+                    !is_volatile<remove_reference_t<Ref>>::value &&
+                    (is_integral<T>::value || is_floating_point<T>::value) &&
+                    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+                     sizeof(T) == 8)> {};
+
+template<class Iter>
+using _simd_value_t =
+    remove_cv_t<remove_reference_t<typename iterator_traits<Iter>::reference>>;
+
+template<class Iter1, class Iter2>
+struct _is_simd_iter2
+    : _and_<_is_simd_iter<Iter1>, _is_simd_iter<Iter2>,
+            is_same<_simd_value_t<Iter1>, _simd_value_t<Iter2>>> {};
+
+// value compared with elements, mixed integers are narrowed after a check
+template<class T, class U>
+struct _is_simd_value
+    : bool_constant<is_same<remove_cv_t<U>, T>::value ||
+                    (is_integral<T>::value && is_integral<U>::value)> {};
+
+template<class T, class U>
+constexpr bool _simd_narrow(const U &value) {
+    using common_t = common_type_t<T, U>;
+    return static_cast<common_t>(static_cast<T>(value)) ==
+           static_cast<common_t>(value);
+}
+
+// Contiguous ranges of trivially copyable values are compacted without
+// branching on the predicate, the ala::intrin kernels pack 4 and 8 byte ones
+template<class Iter>
+struct _is_compact_iter
+    : bool_constant<ALA_USE_SIMD && _is_bitwise_iter<Iter>::value> {};
+
+template<class Iter1, class Iter2>
+struct _is_compact_iter2
+    : _and_<_is_compact_iter<Iter1>, _is_compact_iter<Iter2>,
+            is_same<_simd_value_t<Iter1>, _simd_value_t<Iter2>>> {};
+
+// compared by value, arithmetic of 4 or 8 bytes
+template<class Iter>
+struct _is_simd_compact
+    : _and_<_is_simd_iter<Iter>,
+            bool_constant<sizeof(_simd_value_t<Iter>) == 4 ||
+                          sizeof(_simd_value_t<Iter>) == 8>> {};
+
+template<class Pred, class T>
+struct _is_simd_equal_to
+    : bool_constant<is_same<Pred, equal_to<>>::value ||
+                    is_same<Pred, equal_to<T>>::value> {};
+
+template<class Comp, class T>
+struct _is_simd_less
+    : bool_constant<is_same<Comp, less<>>::value ||
+                    is_same<Comp, less<T>>::value> {};
+
 // Minimum/maximum operations
 #ifdef min
     #warning "undef min macro"
@@ -45,7 +112,8 @@ constexpr enable_if_t<
     !(is_trivial<typename iterator_traits<InputIter>::value_type>::value &&
       is_same<typename iterator_traits<InputIter>::value_type,
               typename iterator_traits<OutputIter>::value_type>::value &&
-      is_pointer<InputIter>::value && is_pointer<OutputIter>::value),
+      is_pointer<InputIter>::value && is_pointer<OutputIter>::value) &&
+        !_is_segmented_iter<InputIter>::value,
     OutputIter>
 copy(InputIter first, InputIter last, OutputIter out) {
     while (first != last)
@@ -79,7 +147,8 @@ constexpr enable_if_t<
     !(is_trivial<typename iterator_traits<InputIter>::value_type>::value &&
       is_same<typename iterator_traits<InputIter>::value_type,
               typename iterator_traits<OutputIter>::value_type>::value &&
-      is_pointer<InputIter>::value && is_pointer<OutputIter>::value),
+      is_pointer<InputIter>::value && is_pointer<OutputIter>::value) &&
+        !_is_segmented_iter<InputIter>::value,
     OutputIter>
 move(InputIter first, InputIter last, OutputIter out) {
     while (first != last)
@@ -108,6 +177,58 @@ move(InputIter first, InputIter last, OutputIter out) {
     return out + (last - first);
 }
 
+// A segmented input is copied (moved with Move) piece by piece, into raw
+// pointers when out is contiguous, so trivial pieces are memmoves
+template<class Iter>
+using _is_contiguous_out =
+    bool_constant<is_pointer<Iter>::value ||
+                  is_base_of<contiguous_iterator_tag,
+                             _iter_concept_t<Iter>>::value>;
+
+template<bool Move, class InputIter, class OutputIter>
+enable_if_t<Move, OutputIter> _copy_piece(InputIter first, InputIter last,
+                                          OutputIter out) {
+    return ala::move(first, last, out);
+}
+
+template<bool Move, class InputIter, class OutputIter>
+enable_if_t<!Move, OutputIter> _copy_piece(InputIter first, InputIter last,
+                                           OutputIter out) {
+    return ala::copy(first, last, out);
+}
+
+template<bool Move, class SegIter, class OutputIter>
+OutputIter _copy_segments(SegIter first, SegIter last, OutputIter out,
+                          false_type) {
+    using local_t = _local_iter_t<SegIter>;
+    ala::for_each_segment(first, last, [&](local_t l, local_t r) {
+        out = ala::_copy_piece<Move>(l, r, out);
+    });
+    return out;
+}
+
+template<bool Move, class SegIter, class OutputIter>
+OutputIter _copy_segments(SegIter first, SegIter last, OutputIter out,
+                          true_type) {
+    auto p = ala::to_address(out);
+    auto q = ala::_copy_segments<Move>(first, last, p, false_type{});
+    return out + (q - p);
+}
+
+template<class InputIter, class OutputIter>
+enable_if_t<_is_segmented_iter<InputIter>::value, OutputIter>
+copy(InputIter first, InputIter last, OutputIter out) {
+    return ala::_copy_segments<false>(first, last, out,
+                                      _is_contiguous_out<OutputIter>{});
+}
+
+template<class InputIter, class OutputIter>
+enable_if_t<_is_segmented_iter<InputIter>::value, OutputIter>
+move(InputIter first, InputIter last, OutputIter out) {
+    return ala::_copy_segments<true>(first, last, out,
+                                     _is_contiguous_out<OutputIter>{});
+}
+
 template<class InputIter, class Size, class OutputIter>
 constexpr enable_if_t<
     !(is_trivial<typename iterator_traits<InputIter>::value_type>::value &&
@@ -249,11 +370,40 @@ move_backward(BidirIter1 first, BidirIter1 last, BidirIter2 out) {
 }
 
 template<class ForwardIter, class T>
-constexpr void fill(ForwardIter first, ForwardIter last, const T &value) {
+constexpr void _fill_dispatch(ForwardIter first, ForwardIter last,
+                              const T &value, false_type) {
     for (; first != last; ++first)
         *first = value;
 }
 
+// trivially copyable values of the element type are stored as bytes
+template<class ForwardIter, class T>
+constexpr void _fill_dispatch(ForwardIter first, ForwardIter last,
+                              const T &value, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_fill_dispatch(first, last, value, false_type{});
+#endif
+    ala::_bitwise_fill(ala::to_address(first), last - first, value);
+}
+
+template<class ForwardIter, class T>
+void _fill_dispatch(ForwardIter first, ForwardIter last, const T &value,
+                    _segmented_tag) {
+    using local_t = _local_iter_t<ForwardIter>;
+    using tag_t = _is_bitwise_fill<local_t, T>;
+    ala::for_each_segment(first, last, [&](local_t l, local_t r) {
+        ala::_fill_dispatch(l, r, value, tag_t{});
+    });
+}
+
+template<class ForwardIter, class T>
+constexpr void fill(ForwardIter first, ForwardIter last, const T &value) {
+    using tag_t = _is_bitwise_fill<ForwardIter, T>;
+    ala::_fill_dispatch(first, last, value,
+                        _segmented_or_t<ForwardIter, tag_t>{});
+}
+
 template<class Iter1, class Iter2>
 constexpr void iter_swap(Iter1 a, Iter2 b) {
     using ala::swap;
@@ -271,13 +421,57 @@ constexpr ForwardIter2 swap_ranges(ForwardIter1 first1, ForwardIter1 last1,
 // Comparison operations
 
 template<class Iter1, class Iter2, class BinPred>
-constexpr bool equal(Iter1 first1, Iter1 last1, Iter2 first2, BinPred pred) {
+constexpr bool _equal_dispatch(Iter1 first1, Iter1 last1, Iter2 first2,
+                               BinPred pred, false_type) {
     for (; first1 != last1; ++first1, (void)++first2)
         if (!pred(*first1, *first2))
             return false;
     return true;
 }
 
+template<class Iter1, class Iter2, class BinPred>
+constexpr bool _equal_dispatch(Iter1 first1, Iter1 last1, Iter2 first2,
+                               BinPred pred, true_type) {
+    using T = _simd_value_t<Iter1>;
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_equal_dispatch(first1, last1, first2, pred, false_type{});
+#endif
+    size_t n = last1 - first1;
+    if (n == 0)
+        return true;
+    const T *p1 = ala::to_address(first1);
+    const T *p2 = ala::to_address(first2);
+    // bitwise equality is only valid without +0.0 == -0.0 and nan
+    if (is_integral<T>::value)
+        return ala::memcmp(p1, p2, n * sizeof(T)) == 0;
+    return ala::intrin::simd_mismatch<false>(p1, p2, n) == n;
+}
+
+// the pieces of first1 against first2, a failed piece skips the rest
+template<class Iter1, class Iter2, class BinPred>
+bool _equal_dispatch(Iter1 first1, Iter1 last1, Iter2 first2, BinPred pred,
+                     _segmented_tag) {
+    using local_t = _local_iter_t<Iter1>;
+    using tag_t = _and_<_is_simd_iter2<local_t, Iter2>,
+                        _is_simd_equal_to<BinPred, _simd_value_t<Iter1>>>;
+    bool eq = true;
+    ala::for_each_segment(first1, last1, [&](local_t l, local_t r) {
+        if (eq)
+            eq = ala::_equal_dispatch(l, r, first2, pred, tag_t{});
+        ala::advance(first2, r - l);
+    });
+    return eq;
+}
+
+template<class Iter1, class Iter2, class BinPred>
+constexpr bool equal(Iter1 first1, Iter1 last1, Iter2 first2, BinPred pred) {
+    using tag_t = _and_<_is_simd_iter2<Iter1, Iter2>,
+                        _is_simd_equal_to<BinPred, _simd_value_t<Iter1>>>;
+    return ala::_equal_dispatch(first1, last1, first2, pred,
+                                _segmented_or_t<Iter1, tag_t>{});
+}
+
 template<class Iter1, class Iter2>
 constexpr bool equal(Iter1 first1, Iter1 last1, Iter2 first2) {
     return ala::equal(first1, last1, first2, equal_to<>());
@@ -315,8 +509,9 @@ constexpr bool equal(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
 }
 
 template<class Iter1, class Iter2, class Compare>
-constexpr bool lexicographical_compare(Iter1 first1, Iter1 last1, Iter2 first2,
-                                       Iter2 last2, Compare comp) {
+constexpr bool _lexicographical_compare_dispatch(Iter1 first1, Iter1 last1,
+                                                 Iter2 first2, Iter2 last2,
+                                                 Compare comp, false_type) {
     for (; (first1 != last1) && (first2 != last2); ++first1, (void)++first2) {
         if (comp(*first1, *first2))
             return true;
@@ -326,6 +521,39 @@ constexpr bool lexicographical_compare(Iter1 first1, Iter1 last1, Iter2 first2,
     return (first1 == last1) && (first2 != last2);
 }
 
+template<class Iter1, class Iter2, class Compare>
+constexpr bool _lexicographical_compare_dispatch(Iter1 first1, Iter1 last1,
+                                                 Iter2 first2, Iter2 last2,
+                                                 Compare comp, true_type) {
+    using T = _simd_value_t<Iter1>;
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_lexicographical_compare_dispatch(
+            first1, last1, first2, last2, comp, false_type{});
+#endif
+    size_t n1 = last1 - first1, n2 = last2 - first2;
+    size_t n = n1 < n2 ? n1 : n2;
+    if (n == 0)
+        return n1 < n2;
+    const T *p1 = ala::to_address(first1);
+    const T *p2 = ala::to_address(first2);
+    size_t i = ala::intrin::simd_mismatch<false>(p1, p2, n);
+    if (i != n)
+        return p1[i] < p2[i];
+    return n1 < n2;
+}
+
+// integral elements only, a total order makes the first mismatch decisive
+template<class Iter1, class Iter2, class Compare>
+constexpr bool lexicographical_compare(Iter1 first1, Iter1 last1, Iter2 first2,
+                                       Iter2 last2, Compare comp) {
+    using tag_t = _and_<_is_simd_iter2<Iter1, Iter2>,
+                        is_integral<_simd_value_t<Iter1>>,
+                        _is_simd_less<Compare, _simd_value_t<Iter1>>>;
+    return ala::_lexicographical_compare_dispatch(first1, last1, first2, last2,
+                                                  comp, tag_t{});
+}
+
 template<class Iter1, class Iter2>
 constexpr bool lexicographical_compare(Iter1 first1, Iter1 last1, Iter2 first2,
                                        Iter2 last2) {
@@ -409,13 +637,49 @@ constexpr bool binary_search(ForwardIter first, ForwardIter last, const T &value
 }
 
 template<class InputIter, class T>
-constexpr InputIter find(InputIter first, InputIter last, const T &value) {
+constexpr InputIter _find_dispatch(InputIter first, InputIter last,
+                                   const T &value, false_type) {
     for (; first != last; ++first)
         if (*first == value)
             return first;
     return last;
 }
 
+template<class InputIter, class T>
+constexpr InputIter _find_dispatch(InputIter first, InputIter last,
+                                   const T &value, true_type) {
+    using V = _simd_value_t<InputIter>;
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_find_dispatch(first, last, value, false_type{});
+#endif
+    if (!ala::_simd_narrow<V>(value))
+        return last;
+    const V *p = ala::to_address(first);
+    const V *q = ala::intrin::simd_find<true>(p, p + (last - first),
+                                             static_cast<V>(value));
+    return first + (q - p);
+}
+
+template<class InputIter, class T>
+InputIter _find_dispatch(InputIter first, InputIter last, const T &value,
+                         _segmented_tag) {
+    using local_t = _local_iter_t<InputIter>;
+    using tag_t = _and_<_is_simd_iter<local_t>,
+                        _is_simd_value<_simd_value_t<local_t>, T>>;
+    return ala::_search_segments(first, last, [&](local_t l, local_t r) {
+        return ala::_find_dispatch(l, r, value, tag_t{});
+    });
+}
+
+template<class InputIter, class T>
+constexpr InputIter find(InputIter first, InputIter last, const T &value) {
+    using tag_t = _and_<_is_simd_iter<InputIter>,
+                        _is_simd_value<_simd_value_t<InputIter>, T>>;
+    return ala::_find_dispatch(first, last, value,
+                               _segmented_or_t<InputIter, tag_t>{});
+}
+
 template<class InputIter, class UnaryPred>
 constexpr InputIter find_if(InputIter first, InputIter last, UnaryPred pred) {
     for (; first != last; ++first)
@@ -425,7 +689,8 @@ constexpr InputIter find_if(InputIter first, InputIter last, UnaryPred pred) {
 }
 
 template<class ForwardIter, class T>
-constexpr ForwardIter remove(ForwardIter first, ForwardIter last, const T &value) {
+constexpr ForwardIter _remove_dispatch(ForwardIter first, ForwardIter last,
+                                       const T &value, false_type) {
     first = ala::find(first, last, value);
     if (first != last)
         for (ForwardIter i = first; ++i != last;)
@@ -434,10 +699,36 @@ constexpr ForwardIter remove(ForwardIter first, ForwardIter last, const T &value
     return first;
 }
 
+template<class ForwardIter, class T>
+constexpr ForwardIter _remove_dispatch(ForwardIter first, ForwardIter last,
+                                       const T &value, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_remove_dispatch(first, last, value, false_type{});
+#endif
+    using V = _simd_value_t<ForwardIter>;
+    if (!ala::_simd_narrow<V>(value))
+        return last;
+    first = ala::find(first, last, value);
+    if (first == last)
+        return last;
+    auto p = ala::to_address(first);
+    auto q = ala::intrin::simd_compact_ne<false>(p + 1, last - first - 1, p,
+                                                 static_cast<V>(value));
+    return first + (q - p);
+}
+
+template<class ForwardIter, class T>
+constexpr ForwardIter remove(ForwardIter first, ForwardIter last, const T &value) {
+    using tag_t = _and_<_is_simd_compact<ForwardIter>,
+                        _is_simd_value<_simd_value_t<ForwardIter>, T>>;
+    return ala::_remove_dispatch(first, last, value, tag_t{});
+}
+
 template<class ForwardIter, class UnaryPred>
-constexpr ForwardIter remove_if(ForwardIter first, ForwardIter last,
-                                UnaryPred pred) {
-    first = ala::find_if(first, last, pred);
+constexpr ForwardIter _remove_if_dispatch(ForwardIter first, ForwardIter last,
+                                          UnaryPred &pred, false_type) {
+    first = ala::find_if<ForwardIter, UnaryPred &>(first, last, pred);
     if (first != last)
         for (ForwardIter i = first; ++i != last;)
             if (!pred(*i))
@@ -445,6 +736,29 @@ constexpr ForwardIter remove_if(ForwardIter first, ForwardIter last,
     return first;
 }
 
+template<class ForwardIter, class UnaryPred>
+constexpr ForwardIter _remove_if_dispatch(ForwardIter first, ForwardIter last,
+                                          UnaryPred &pred, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_remove_if_dispatch(first, last, pred, false_type{});
+#endif
+    first = ala::find_if<ForwardIter, UnaryPred &>(first, last, pred);
+    if (first == last)
+        return last;
+    auto p = ala::to_address(first);
+    auto q = ala::intrin::simd_compact_if<false, false>(p + 1, last - first - 1,
+                                                        p, pred);
+    return first + (q - p);
+}
+
+template<class ForwardIter, class UnaryPred>
+constexpr ForwardIter remove_if(ForwardIter first, ForwardIter last,
+                                UnaryPred pred) {
+    return ala::_remove_if_dispatch(first, last, pred,
+                                    _is_compact_iter<ForwardIter>{});
+}
+
 template<class ForwardIter>
 constexpr ForwardIter _rotate_left(ForwardIter first, ForwardIter last) {
     using T = typename iterator_traits<ForwardIter>::value_type;
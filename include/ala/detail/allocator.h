@@ -399,6 +399,20 @@ struct allocator_traits {
     }
 };
 
+// Alloc constructs at raw pointers by placement new, containers may then
+// construct through the uninitialized algorithms, which copy and fill
+// trivially copyable values as bytes
+template<class Alloc, class Traits = allocator_traits<Alloc>>
+struct _is_plain_construct
+    : bool_constant<is_pointer<typename Traits::pointer>::value &&
+                    !Traits::template _has_construct<
+                        void, Alloc &, typename Traits::pointer,
+                        const typename Traits::value_type &>::value> {};
+
+template<class T>
+struct _is_plain_construct<allocator<T>, allocator_traits<allocator<T>>>
+    : true_type {};
+
 template<typename T, typename = void>
 struct _is_allocator: false_type {};
 
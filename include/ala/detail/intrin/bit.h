@@ -14,6 +14,11 @@ extern unsigned char _BitScanReverse64(unsigned long *, __int64);
 extern unsigned __int64 __popcnt64(unsigned __int64);
     #endif
 
+    #if defined(_ALA_X64)
+extern unsigned __int64 _umul128(unsigned __int64, unsigned __int64,
+                                 unsigned __int64 *);
+    #endif
+
 #endif
 
 namespace ala {
@@ -150,6 +155,30 @@ inline uint64_t bswap(uint64_t x) noexcept { return ala::intrin::bswap64(x); }
 
 // clang-format on
 
+// low half of the double width product, the high half to *hi
+inline uint64_t umul(uint64_t a, uint64_t b, uint64_t *hi) noexcept {
+#if _ALA_ENABLE_INT128T
+    __uint128_t p = static_cast<__uint128_t>(a) * b;
+    *hi = static_cast<uint64_t>(p >> 64);
+    return static_cast<uint64_t>(p);
+#elif defined(_ALA_MSVC) && defined(_ALA_X64)
+    return _umul128(a, b, hi);
+#else
+    uint64_t al = a & 0xffffffffU, ah = a >> 32;
+    uint64_t bl = b & 0xffffffffU, bh = b >> 32;
+    uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+    uint64_t mid = (ll >> 32) + (lh & 0xffffffffU) + (hl & 0xffffffffU);
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return (mid << 32) | (ll & 0xffffffffU);
+#endif
+}
+
+inline uint32_t umul(uint32_t a, uint32_t b, uint32_t *hi) noexcept {
+    uint64_t p = static_cast<uint64_t>(a) * b;
+    *hi = static_cast<uint32_t>(p >> 32);
+    return static_cast<uint32_t>(p);
+}
+
 } // namespace intrin
 } // namespace ala
 #endif
\ No newline at end of file
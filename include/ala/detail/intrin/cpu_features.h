@@ -0,0 +1,174 @@
+#ifndef _ALA_INTRIN_CPU_FEATURES_H
+#define _ALA_INTRIN_CPU_FEATURES_H
+
+#include <ala/config.h>
+
+#ifdef _ALA_X86
+    #if defined(_ALA_MSVC)
+        #include <immintrin.h>
+    #endif
+    #include <ala/detail/intrin/cpuid.h>
+#endif
+
+namespace ala {
+namespace intrin {
+
+// Features the processor has and the os saves the registers of, false
+// off x86.
+struct cpu_feature_set {
+    bool sse42;
+    bool popcnt;
+    bool aes;
+    bool pclmul;
+    bool rdrand;
+    bool rdseed;
+    bool avx;
+    bool fma;
+    bool avx2;
+    bool bmi1;
+    bool bmi2;
+    bool avx512f;
+    bool avx512dq;
+    bool avx512cd;
+    bool avx512bw;
+    bool avx512vl;
+    bool avx512_vbmi;
+    bool avx512_vpopcntdq;
+};
+
+struct _cpu_feature_name {
+    const char *name;
+    bool cpu_feature_set::*flag;
+};
+
+#ifdef _ALA_X86
+
+inline unsigned long long _xgetbv0() {
+    #if defined(_ALA_MSVC)
+    return _xgetbv(0);
+    #else
+    unsigned int eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+    #endif
+}
+
+// The leaves are read into locals, the CPUIDInfo getters cache them in
+// statics that need guard variables
+inline cpu_feature_set _detect_x86_features() {
+    const CPUIDInfo l1(1), l7(7);
+    cpu_feature_set f = {};
+    f.pclmul = l1.ecx[1];
+    f.sse42 = l1.ecx[20];
+    f.popcnt = l1.ecx[23];
+    f.aes = l1.ecx[25];
+    f.rdrand = l1.ecx[30];
+    f.bmi1 = l7.ebx[3];
+    f.bmi2 = l7.ebx[8];
+    f.rdseed = l7.ebx[18];
+    // OSXSAVE, the os saves ymm/zmm registers on context switch
+    unsigned long long xcr0 = l1.ecx[27] ? _xgetbv0() : 0;
+    if ((xcr0 & 0x6) != 0x6)
+        return f;
+    f.avx = l1.ecx[28];
+    f.fma = f.avx && l1.ecx[12];
+    f.avx2 = f.avx && l7.ebx[5];
+    if ((xcr0 & 0xe0) != 0xe0)
+        return f;
+    f.avx512f = f.avx2 && l7.ebx[16];
+    f.avx512dq = f.avx512f && l7.ebx[17];
+    f.avx512cd = f.avx512f && l7.ebx[28];
+    f.avx512bw = f.avx512f && l7.ebx[30];
+    f.avx512vl = f.avx512f && l7.ebx[31];
+    f.avx512_vbmi = f.avx512f && l7.ecx[1];
+    f.avx512_vpopcntdq = f.avx512f && l7.ecx[14];
+    return f;
+}
+
+#endif
+
+// Reads cpuid on every call, no statics and no ALA_CPU_DISABLE
+inline cpu_feature_set detect_cpu_features() {
+#ifdef _ALA_X86
+    return ala::intrin::_detect_x86_features();
+#else
+    return cpu_feature_set{};
+#endif
+}
+
+// Clears the features named in ALA_CPU_DISABLE, a list separated by commas
+// or spaces, "all" names every one. Lets a test run each path of a kernel
+// on a machine that has the widest.
+inline void _apply_cpu_disable(cpu_feature_set &f) {
+    static constexpr _cpu_feature_name names[] = {
+        {"sse42", &cpu_feature_set::sse42},
+        {"popcnt", &cpu_feature_set::popcnt},
+        {"aes", &cpu_feature_set::aes},
+        {"pclmul", &cpu_feature_set::pclmul},
+        {"rdrand", &cpu_feature_set::rdrand},
+        {"rdseed", &cpu_feature_set::rdseed},
+        {"avx", &cpu_feature_set::avx},
+        {"fma", &cpu_feature_set::fma},
+        {"avx2", &cpu_feature_set::avx2},
+        {"bmi1", &cpu_feature_set::bmi1},
+        {"bmi2", &cpu_feature_set::bmi2},
+        {"avx512f", &cpu_feature_set::avx512f},
+        {"avx512dq", &cpu_feature_set::avx512dq},
+        {"avx512cd", &cpu_feature_set::avx512cd},
+        {"avx512bw", &cpu_feature_set::avx512bw},
+        {"avx512vl", &cpu_feature_set::avx512vl},
+        {"avx512_vbmi", &cpu_feature_set::avx512_vbmi},
+        {"avx512_vpopcntdq", &cpu_feature_set::avx512_vpopcntdq},
+    };
+    const char *s = ::std::getenv("ALA_CPU_DISABLE");
+    if (s == nullptr)
+        return;
+    while (*s != '\0') {
+        const char *e = s;
+        while (*e != '\0' && *e != ',' && *e != ' ')
+            ++e;
+        size_t n = e - s;
+        bool all = n == 3 && ala::memcmp(s, "all", 3) == 0;
+        for (const _cpu_feature_name &c : names) {
+            if (all || (::std::strlen(c.name) == n &&
+                        ala::memcmp(s, c.name, n) == 0))
+                f.*c.flag = false;
+        }
+        s = *e == '\0' ? e : e + 1;
+    }
+    // what builds on a disabled feature goes with it, as in detection
+    f.fma = f.fma && f.avx;
+    f.avx2 = f.avx2 && f.avx;
+    f.avx512f = f.avx512f && f.avx2;
+    f.avx512dq = f.avx512dq && f.avx512f;
+    f.avx512cd = f.avx512cd && f.avx512f;
+    f.avx512bw = f.avx512bw && f.avx512f;
+    f.avx512vl = f.avx512vl && f.avx512f;
+    f.avx512_vbmi = f.avx512_vbmi && f.avx512f;
+    f.avx512_vpopcntdq = f.avx512_vpopcntdq && f.avx512f;
+}
+
+// Detected once, the first call reads cpuid and the environment.
+inline const cpu_feature_set &cpu_features() {
+    static const cpu_feature_set features = [] {
+        cpu_feature_set f = ala::intrin::detect_cpu_features();
+        ala::intrin::_apply_cpu_disable(f);
+        return f;
+    }();
+    return features;
+}
+
+// The implementation Resolve picks, called on first use only. Later calls
+// cost an indirect call, as through an ifunc, plus the check of a static
+// that is initialized. Keyed by Resolve, so templates and inline
+// functions of a header get one pointer each.
+template<class Fp, Fp (*Resolve)()>
+inline Fp resolve_once() {
+    static const Fp f = Resolve();
+    return f;
+}
+
+} // namespace intrin
+} // namespace ala
+
+#endif // HEAD
@@ -29,12 +29,12 @@ namespace ala {
 // and
 // Intel® 64 and IA-32 Architectures Software Developer’s Manual Volume 2 - 3.2
 struct CPUIDInfo {
+    // keep trivial, anonymous union members can not have constructors
+    // exactly 32 bits, cpuid writes four unsigned int registers through data
     struct bits32 {
-        uint_fast32_t data = 0;
+        uint32_t data;
 
-        bits32(uint_fast32_t _data): data(_data) {}
-
-        operator uint_fast32_t() const {
+        operator uint32_t() const {
             return data;
         }
 
@@ -42,30 +42,36 @@ struct CPUIDInfo {
             return (data >> index) & 1;
         }
 
-        uint_fast32_t operator()(size_t start, size_t end) const {
-            return (data >> start) & (0xffffffff >> (32 - end + start));
+        // bits [start, end], inclusive
+        uint32_t operator()(size_t start, size_t end) const {
+            return (data >> start) & (0xffffffffu >> (31 - end + start));
         }
     };
     union {
-        uint_fast32_t data[4];
+        uint32_t data[4];
         struct {
             bits32 eax, ebx, ecx, edx;
         };
     };
 
+    // registers of leaf, all zero if the processor does not have it
     bool operator()(unsigned int leaf, unsigned int subleaf = 0) {
 #ifdef _ALA_MSVC
         __cpuid((int *)data, leaf & 0x80000000);
         unsigned int max_leaf = eax;
-        if (max_leaf == 0 || max_leaf < leaf)
+        if (max_leaf == 0 || max_leaf < leaf) {
+            data[0] = data[1] = data[2] = data[3] = 0;
             return false;
+        }
         __cpuidex((int *)data, leaf, subleaf);
         return true;
 #else
         __cpuid(leaf & 0x80000000, data[0], data[1], data[2], data[3]);
         unsigned int max_leaf = eax;
-        if (max_leaf == 0 || max_leaf < leaf)
+        if (max_leaf == 0 || max_leaf < leaf) {
+            data[0] = data[1] = data[2] = data[3] = 0;
             return false;
+        }
         __cpuid_count(leaf, subleaf, data[0], data[1], data[2], data[3]);
         return true;
 #endif
@@ -189,6 +195,10 @@ struct CPUIDInfo {
         return GetInfo1().ecx[0];
     }
 
+    static bool GetPCLMULQDQ() {
+        return GetInfo1().ecx[1];
+    }
+
     static bool GetSSSE3() {
         return GetInfo1().ecx[9];
     }
@@ -205,6 +215,18 @@ struct CPUIDInfo {
         return GetInfo1().ecx[20];
     }
 
+    static bool GetPOPCNT() {
+        return GetInfo1().ecx[23];
+    }
+
+    static bool GetAES() {
+        return GetInfo1().ecx[25];
+    }
+
+    static bool GetOSXSAVE() {
+        return GetInfo1().ecx[27];
+    }
+
     static bool GetAVX() {
         return GetInfo1().ecx[28];
     }
@@ -219,6 +241,10 @@ struct CPUIDInfo {
 
     // Others
 
+    static bool GetBMI1() {
+        return GetInfo7().ebx[3];
+    }
+
     static bool GetHLE() {
         return GetInfo7().ebx[4];
     }
@@ -227,6 +253,10 @@ struct CPUIDInfo {
         return GetInfo7().ebx[5];
     }
 
+    static bool GetBMI2() {
+        return GetInfo7().ebx[8];
+    }
+
     static bool GetAVX512F() {
         return GetInfo7().ebx[16];
     }
@@ -308,14 +338,16 @@ struct CPUIDInfo {
     //     return 0;
     // }
 
+    // empty if the processor has no brand string leaves
     static char *GetProcessorName() {
         static char pc_name[49] = {};
-        CPUIDInfo info(0x80000002);
-        ala::memcpy(pc_name, info.data, 16);
-        info(0x80000003);
-        ala::memcpy(pc_name + 16, info.data, 16);
-        info(0x80000004);
-        ala::memcpy(pc_name + 32, info.data, 16);
+        CPUIDInfo info(0x80000000);
+        if (info.eax < 0x80000004)
+            return pc_name;
+        for (unsigned int i = 0; i != 3; ++i) {
+            info(0x80000002 + i);
+            ala::memcpy(pc_name + 16 * i, info.data, 16);
+        }
         return pc_name;
     }
 };
@@ -69,7 +69,7 @@ namespace intrin {
         #endif
 
         #ifdef ALA_POP__RDSEED__
-        #pragma GCC push_options
+        #pragma GCC pop_options
         #undef ALA_POP__RDSEED__
         #endif // ALA_POP__RDSEED__
 
@@ -0,0 +1,957 @@
+#ifndef _ALA_INTRIN_SIMD_H
+#define _ALA_INTRIN_SIMD_H
+
+#include <ala/config.h>
+#include <ala/type_traits.h>
+#include <ala/detail/intrin/bit.h>
+#include <ala/detail/intrin/cpu_features.h>
+
+#if ALA_USE_SIMD && defined(_ALA_X86) && \
+    (defined(_ALA_X64) || defined(__SSE2__) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define _ALA_SIMD_X86 1
+#else
+    #define _ALA_SIMD_X86 0
+#endif
+
+#if defined(_ALA_MSVC)
+    #define ALA_TARGET(...)
+#else
+    #define ALA_TARGET(...) __attribute__((target(__VA_ARGS__)))
+#endif
+
+#if _ALA_SIMD_X86
+    #include <immintrin.h>
+#endif
+
+namespace ala {
+namespace intrin {
+
+// Kernels are compiled once per isa, sse2 is the x86 baseline, avx2 is
+// selected at runtime, everything else falls back to scalar loops. The
+// level follows cpu_features(), ALA_CPU_DISABLE=avx2 runs the sse2 kernels.
+enum simd_level_t : int {
+    simd_scalar = 0,
+    simd_sse2 = 1,
+    simd_avx2 = 2,
+    simd_avx512 = 3,
+};
+
+#if _ALA_SIMD_X86
+
+inline int _detect_simd_level() {
+    const cpu_feature_set &f = ala::intrin::cpu_features();
+    // avx2 kernels also use popcnt
+    if (!f.avx2 || !f.popcnt)
+        return simd_sse2;
+    if (!f.avx512f || !f.avx512bw || !f.avx512vl)
+        return simd_avx2;
+    return simd_avx512;
+}
+
+#endif
+
+inline int simd_level() {
+#if _ALA_SIMD_X86
+    static const int level = ala::intrin::_detect_simd_level();
+    return level;
+#else
+    return simd_scalar;
+#endif
+}
+
+#if _ALA_SIMD_X86
+
+// Lane operations, eq yields all-ones lanes, mask takes one bit per byte,
+// so a lane index is ctz(mask) / sizeof(T).
+namespace sse2 {
+
+struct _vec_base {
+    using type = __m128i;
+    static constexpr size_t bytes = 16;
+    static constexpr unsigned full = 0xffff;
+
+    static type zero() {
+        return _mm_setzero_si128();
+    }
+
+    static type load(const void *p) {
+        return _mm_loadu_si128((const __m128i *)p);
+    }
+
+    static void store(void *p, type a) {
+        _mm_storeu_si128((__m128i *)p, a);
+    }
+
+    // lanes of b where m is set
+    static type blend(type m, type a, type b) {
+        return _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, a));
+    }
+
+    static type bor(type a, type b) {
+        return _mm_or_si128(a, b);
+    }
+
+    static type band(type a, type b) {
+        return _mm_and_si128(a, b);
+    }
+
+    static type bxor(type a, type b) {
+        return _mm_xor_si128(a, b);
+    }
+
+    static unsigned mask(type a) {
+        return (unsigned)_mm_movemask_epi8(a);
+    }
+};
+
+template<class T, size_t = sizeof(T), bool = is_floating_point<T>::value>
+struct vec;
+
+template<class T>
+struct vec<T, 1, false>: _vec_base {
+    static constexpr size_t size = 16;
+
+    static type set1(T v) {
+        return _mm_set1_epi8((char)v);
+    }
+
+    static type eq(type a, type b) {
+        return _mm_cmpeq_epi8(a, b);
+    }
+
+    static type gt(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm_cmpgt_epi8(a, b);
+        const type s = _mm_set1_epi8((char)0x80);
+        return _mm_cmpgt_epi8(_mm_xor_si128(a, s), _mm_xor_si128(b, s));
+    }
+
+    static type min(type a, type b) {
+        if (is_signed<T>::value)
+            return blend(gt(a, b), a, b);
+        return _mm_min_epu8(a, b);
+    }
+
+    static type max(type a, type b) {
+        if (is_signed<T>::value)
+            return blend(gt(b, a), a, b);
+        return _mm_max_epu8(a, b);
+    }
+
+    static type unord(type) {
+        return zero();
+    }
+};
+
+template<class T>
+struct vec<T, 2, false>: _vec_base {
+    static constexpr size_t size = 8;
+
+    static type set1(T v) {
+        return _mm_set1_epi16((short)v);
+    }
+
+    static type eq(type a, type b) {
+        return _mm_cmpeq_epi16(a, b);
+    }
+
+    static type gt(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm_cmpgt_epi16(a, b);
+        const type s = _mm_set1_epi16((short)0x8000);
+        return _mm_cmpgt_epi16(_mm_xor_si128(a, s), _mm_xor_si128(b, s));
+    }
+
+    static type min(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm_min_epi16(a, b);
+        return blend(gt(a, b), a, b);
+    }
+
+    static type max(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm_max_epi16(a, b);
+        return blend(gt(b, a), a, b);
+    }
+
+    static type unord(type) {
+        return zero();
+    }
+};
+
+template<class T>
+struct vec<T, 4, false>: _vec_base {
+    static constexpr size_t size = 4;
+
+    static type set1(T v) {
+        return _mm_set1_epi32((int)v);
+    }
+
+    static type eq(type a, type b) {
+        return _mm_cmpeq_epi32(a, b);
+    }
+
+    static type gt(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm_cmpgt_epi32(a, b);
+        const type s = _mm_set1_epi32((int)0x80000000);
+        return _mm_cmpgt_epi32(_mm_xor_si128(a, s), _mm_xor_si128(b, s));
+    }
+
+    static type min(type a, type b) {
+        return blend(gt(a, b), a, b);
+    }
+
+    static type max(type a, type b) {
+        return blend(gt(b, a), a, b);
+    }
+
+    static type unord(type) {
+        return zero();
+    }
+
+    static type add(type a, type b) {
+        return _mm_add_epi32(a, b);
+    }
+
+    // inclusive prefix sum of the lanes
+    static type prefix(type x) {
+        x = add(x, _mm_slli_si128(x, 4));
+        return add(x, _mm_slli_si128(x, 8));
+    }
+
+    // lanes moved up by one, lane 0 cleared
+    static type shift1(type x) {
+        return _mm_slli_si128(x, 4);
+    }
+
+    static type bcast_last(type x) {
+        return _mm_shuffle_epi32(x, 0xff);
+    }
+
+    // low halves of the 64 bit products of the lanes, high halves to hi
+    static type mulhilo(type a, type b, type &hi) {
+        type even = _mm_mul_epu32(a, b);
+        type odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        const type low = _mm_set1_epi64x(0xffffffff);
+        hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(low, odd));
+        return _mm_or_si128(_mm_and_si128(even, low), _mm_slli_epi64(odd, 32));
+    }
+
+    // lane i of a, b, c and d to lanes 4i to 4i + 3 of p
+    static void store4(void *p, type a, type b, type c, type d) {
+        type ab0 = _mm_unpacklo_epi32(a, b), ab1 = _mm_unpackhi_epi32(a, b);
+        type cd0 = _mm_unpacklo_epi32(c, d), cd1 = _mm_unpackhi_epi32(c, d);
+        char *q = static_cast<char *>(p);
+        store(q, _mm_unpacklo_epi64(ab0, cd0));
+        store(q + 16, _mm_unpackhi_epi64(ab0, cd0));
+        store(q + 32, _mm_unpacklo_epi64(ab1, cd1));
+        store(q + 48, _mm_unpackhi_epi64(ab1, cd1));
+    }
+};
+
+template<class T>
+struct vec<T, 8, false>: _vec_base {
+    static constexpr size_t size = 2;
+
+    static type set1(T v) {
+        return _mm_set1_epi64x((long long)v);
+    }
+
+    // no pcmpeqq before sse4.1, both halves must match
+    static type eq(type a, type b) {
+        type e = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+
+    // no pcmpgtq before sse4.2, high halves decide unless equal, then the
+    // borrow of b - a does
+    static type gt(type a, type b) {
+        if (!is_signed<T>::value) {
+            const type s = _mm_set1_epi64x((long long)0x8000000000000000ull);
+            a = _mm_xor_si128(a, s);
+            b = _mm_xor_si128(b, s);
+        }
+        type r = _mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_sub_epi64(b, a));
+        r = _mm_or_si128(r, _mm_cmpgt_epi32(a, b));
+        return _mm_shuffle_epi32(r, _MM_SHUFFLE(3, 3, 1, 1));
+    }
+
+    static type min(type a, type b) {
+        return blend(gt(a, b), a, b);
+    }
+
+    static type max(type a, type b) {
+        return blend(gt(b, a), a, b);
+    }
+
+    static type unord(type) {
+        return zero();
+    }
+
+    static type add(type a, type b) {
+        return _mm_add_epi64(a, b);
+    }
+
+    // inclusive prefix sum of the lanes
+    static type prefix(type x) {
+        return add(x, _mm_slli_si128(x, 8));
+    }
+
+    // lanes moved up by one, lane 0 cleared
+    static type shift1(type x) {
+        return _mm_slli_si128(x, 8);
+    }
+
+    static type bcast_last(type x) {
+        return _mm_shuffle_epi32(x, 0xee);
+    }
+
+    template<int K>
+    static type shl(type x) {
+        return _mm_slli_epi64(x, K);
+    }
+
+    template<int K>
+    static type shr(type x) {
+        return _mm_srli_epi64(x, K);
+    }
+
+    // bits of the double in [0, 1) made of the high 52 bits of each lane
+    static type unit_double(type x) {
+        const type one = _mm_set1_epi64x(0x3ff0000000000000ll);
+        __m128d d = _mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(x, 12), one));
+        return _mm_castpd_si128(_mm_sub_pd(d, _mm_castsi128_pd(one)));
+    }
+
+    // bits of two floats in [0, 1) per lane, one of the high 23 bits of
+    // each half
+    static type unit_float(type x) {
+        const type one = _mm_set1_epi32(0x3f800000);
+        __m128 f = _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(x, 9), one));
+        return _mm_castps_si128(_mm_sub_ps(f, _mm_castsi128_ps(one)));
+    }
+};
+
+template<class T>
+struct vec<T, 4, true>: _vec_base {
+    static constexpr size_t size = 4;
+
+    static type set1(T v) {
+        return _mm_castps_si128(_mm_set1_ps(v));
+    }
+
+    static type eq(type a, type b) {
+        return _mm_castps_si128(
+            _mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+
+    static type min(type a, type b) {
+        return _mm_castps_si128(
+            _mm_min_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+
+    static type max(type a, type b) {
+        return _mm_castps_si128(
+            _mm_max_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+
+    static type unord(type a) {
+        __m128 x = _mm_castsi128_ps(a);
+        return _mm_castps_si128(_mm_cmpunord_ps(x, x));
+    }
+
+    static type add(type a, type b) {
+        return _mm_castps_si128(
+            _mm_add_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+
+    static type mul(type a, type b) {
+        return _mm_castps_si128(
+            _mm_mul_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+
+    // inclusive prefix sum of the lanes
+    static type prefix(type x) {
+        x = add(x, _mm_slli_si128(x, 4));
+        return add(x, _mm_slli_si128(x, 8));
+    }
+
+    // lanes moved up by one, lane 0 cleared
+    static type shift1(type x) {
+        return _mm_slli_si128(x, 4);
+    }
+
+    static type bcast_last(type x) {
+        return _mm_shuffle_epi32(x, 0xff);
+    }
+};
+
+template<class T>
+struct vec<T, 8, true>: _vec_base {
+    static constexpr size_t size = 2;
+
+    static type set1(T v) {
+        return _mm_castpd_si128(_mm_set1_pd(v));
+    }
+
+    static type eq(type a, type b) {
+        return _mm_castpd_si128(
+            _mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+
+    static type min(type a, type b) {
+        return _mm_castpd_si128(
+            _mm_min_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+
+    static type max(type a, type b) {
+        return _mm_castpd_si128(
+            _mm_max_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+
+    static type unord(type a) {
+        __m128d x = _mm_castsi128_pd(a);
+        return _mm_castpd_si128(_mm_cmpunord_pd(x, x));
+    }
+
+    static type add(type a, type b) {
+        return _mm_castpd_si128(
+            _mm_add_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+
+    static type mul(type a, type b) {
+        return _mm_castpd_si128(
+            _mm_mul_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+
+    // inclusive prefix sum of the lanes
+    static type prefix(type x) {
+        return add(x, _mm_slli_si128(x, 8));
+    }
+
+    // lanes moved up by one, lane 0 cleared
+    static type shift1(type x) {
+        return _mm_slli_si128(x, 8);
+    }
+
+    static type bcast_last(type x) {
+        return _mm_shuffle_epi32(x, 0xee);
+    }
+};
+
+} // namespace sse2
+
+namespace avx2 {
+
+struct _vec_base {
+    using type = __m256i;
+    static constexpr size_t bytes = 32;
+    static constexpr unsigned full = 0xffffffff;
+
+    ALA_TARGET("avx2") static type zero() {
+        return _mm256_setzero_si256();
+    }
+
+    ALA_TARGET("avx2") static type load(const void *p) {
+        return _mm256_loadu_si256((const __m256i *)p);
+    }
+
+    ALA_TARGET("avx2") static void store(void *p, type a) {
+        _mm256_storeu_si256((__m256i *)p, a);
+    }
+
+    // lanes of b where m is set
+    ALA_TARGET("avx2") static type blend(type m, type a, type b) {
+        return _mm256_blendv_epi8(a, b, m);
+    }
+
+    ALA_TARGET("avx2") static type bor(type a, type b) {
+        return _mm256_or_si256(a, b);
+    }
+
+    ALA_TARGET("avx2") static type band(type a, type b) {
+        return _mm256_and_si256(a, b);
+    }
+
+    ALA_TARGET("avx2") static type bxor(type a, type b) {
+        return _mm256_xor_si256(a, b);
+    }
+
+    ALA_TARGET("avx2") static unsigned mask(type a) {
+        return (unsigned)_mm256_movemask_epi8(a);
+    }
+};
+
+template<class T, size_t = sizeof(T), bool = is_floating_point<T>::value>
+struct vec;
+
+template<class T>
+struct vec<T, 1, false>: _vec_base {
+    static constexpr size_t size = 32;
+
+    ALA_TARGET("avx2") static type set1(T v) {
+        return _mm256_set1_epi8((char)v);
+    }
+
+    ALA_TARGET("avx2") static type eq(type a, type b) {
+        return _mm256_cmpeq_epi8(a, b);
+    }
+
+    ALA_TARGET("avx2") static type gt(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm256_cmpgt_epi8(a, b);
+        const type s = _mm256_set1_epi8((char)0x80);
+        return _mm256_cmpgt_epi8(_mm256_xor_si256(a, s),
+                               _mm256_xor_si256(b, s));
+    }
+
+    ALA_TARGET("avx2") static type min(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm256_min_epi8(a, b);
+        return _mm256_min_epu8(a, b);
+    }
+
+    ALA_TARGET("avx2") static type max(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm256_max_epi8(a, b);
+        return _mm256_max_epu8(a, b);
+    }
+
+    ALA_TARGET("avx2") static type unord(type) {
+        return zero();
+    }
+};
+
+template<class T>
+struct vec<T, 2, false>: _vec_base {
+    static constexpr size_t size = 16;
+
+    ALA_TARGET("avx2") static type set1(T v) {
+        return _mm256_set1_epi16((short)v);
+    }
+
+    ALA_TARGET("avx2") static type eq(type a, type b) {
+        return _mm256_cmpeq_epi16(a, b);
+    }
+
+    ALA_TARGET("avx2") static type gt(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm256_cmpgt_epi16(a, b);
+        const type s = _mm256_set1_epi16((short)0x8000);
+        return _mm256_cmpgt_epi16(_mm256_xor_si256(a, s),
+                               _mm256_xor_si256(b, s));
+    }
+
+    ALA_TARGET("avx2") static type min(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm256_min_epi16(a, b);
+        return _mm256_min_epu16(a, b);
+    }
+
+    ALA_TARGET("avx2") static type max(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm256_max_epi16(a, b);
+        return _mm256_max_epu16(a, b);
+    }
+
+    ALA_TARGET("avx2") static type unord(type) {
+        return zero();
+    }
+};
+
+template<class T>
+struct vec<T, 4, false>: _vec_base {
+    static constexpr size_t size = 8;
+
+    ALA_TARGET("avx2") static type set1(T v) {
+        return _mm256_set1_epi32((int)v);
+    }
+
+    ALA_TARGET("avx2") static type eq(type a, type b) {
+        return _mm256_cmpeq_epi32(a, b);
+    }
+
+    ALA_TARGET("avx2") static type gt(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm256_cmpgt_epi32(a, b);
+        const type s = _mm256_set1_epi32((int)0x80000000);
+        return _mm256_cmpgt_epi32(_mm256_xor_si256(a, s),
+                               _mm256_xor_si256(b, s));
+    }
+
+    ALA_TARGET("avx2") static type min(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm256_min_epi32(a, b);
+        return _mm256_min_epu32(a, b);
+    }
+
+    ALA_TARGET("avx2") static type max(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm256_max_epi32(a, b);
+        return _mm256_max_epu32(a, b);
+    }
+
+    ALA_TARGET("avx2") static type unord(type) {
+        return zero();
+    }
+
+    ALA_TARGET("avx2") static type add(type a, type b) {
+        return _mm256_add_epi32(a, b);
+    }
+
+    // inclusive prefix sum of the lanes, in each half then across them
+    ALA_TARGET("avx2") static type prefix(type x) {
+        x = add(x, _mm256_slli_si256(x, 4));
+        x = add(x, _mm256_slli_si256(x, 8));
+        type t = _mm256_shuffle_epi32(x, 0xff);
+        return add(x, _mm256_permute2x128_si256(t, t, 0x08));
+    }
+
+    // lanes moved up by one, lane 0 cleared
+    ALA_TARGET("avx2") static type shift1(type x) {
+        return _mm256_alignr_epi8(x, _mm256_permute2x128_si256(x, x, 0x08),
+                                  12);
+    }
+
+    ALA_TARGET("avx2") static type bcast_last(type x) {
+        return _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+    }
+
+    // low halves of the 64 bit products of the lanes, high halves to hi
+    ALA_TARGET("avx2") static type mulhilo(type a, type b, type &hi) {
+        type even = _mm256_mul_epu32(a, b);
+        type odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32),
+                                    _mm256_srli_epi64(b, 32));
+        hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa);
+        return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xaa);
+    }
+
+    // lane i of a, b, c and d to lanes 4i to 4i + 3 of p, transposed in
+    // each half, the halves hold lanes i and i + 4
+    ALA_TARGET("avx2") static void store4(void *p, type a, type b, type c,
+                                          type d) {
+        type ab0 = _mm256_unpacklo_epi32(a, b);
+        type ab1 = _mm256_unpackhi_epi32(a, b);
+        type cd0 = _mm256_unpacklo_epi32(c, d);
+        type cd1 = _mm256_unpackhi_epi32(c, d);
+        type r0 = _mm256_unpacklo_epi64(ab0, cd0);
+        type r1 = _mm256_unpackhi_epi64(ab0, cd0);
+        type r2 = _mm256_unpacklo_epi64(ab1, cd1);
+        type r3 = _mm256_unpackhi_epi64(ab1, cd1);
+        char *q = static_cast<char *>(p);
+        store(q, _mm256_permute2x128_si256(r0, r1, 0x20));
+        store(q + 32, _mm256_permute2x128_si256(r2, r3, 0x20));
+        store(q + 64, _mm256_permute2x128_si256(r0, r1, 0x31));
+        store(q + 96, _mm256_permute2x128_si256(r2, r3, 0x31));
+    }
+};
+
+template<class T>
+struct vec<T, 8, false>: _vec_base {
+    static constexpr size_t size = 4;
+
+    ALA_TARGET("avx2") static type set1(T v) {
+        return _mm256_set1_epi64x((long long)v);
+    }
+
+    ALA_TARGET("avx2") static type eq(type a, type b) {
+        return _mm256_cmpeq_epi64(a, b);
+    }
+
+    ALA_TARGET("avx2") static type gt(type a, type b) {
+        if (is_signed<T>::value)
+            return _mm256_cmpgt_epi64(a, b);
+        const type s = _mm256_set1_epi64x((long long)0x8000000000000000ull);
+        return _mm256_cmpgt_epi64(_mm256_xor_si256(a, s),
+                               _mm256_xor_si256(b, s));
+    }
+
+    ALA_TARGET("avx2") static type min(type a, type b) {
+        return blend(gt(a, b), a, b);
+    }
+
+    ALA_TARGET("avx2") static type max(type a, type b) {
+        return blend(gt(b, a), a, b);
+    }
+
+    ALA_TARGET("avx2") static type unord(type) {
+        return zero();
+    }
+
+    ALA_TARGET("avx2") static type add(type a, type b) {
+        return _mm256_add_epi64(a, b);
+    }
+
+    // inclusive prefix sum of the lanes, in each half then across them
+    ALA_TARGET("avx2") static type prefix(type x) {
+        x = add(x, _mm256_slli_si256(x, 8));
+        type t = _mm256_shuffle_epi32(x, 0xee);
+        return add(x, _mm256_permute2x128_si256(t, t, 0x08));
+    }
+
+    // lanes moved up by one, lane 0 cleared
+    ALA_TARGET("avx2") static type shift1(type x) {
+        return _mm256_alignr_epi8(x, _mm256_permute2x128_si256(x, x, 0x08),
+                                  8);
+    }
+
+    ALA_TARGET("avx2") static type bcast_last(type x) {
+        return _mm256_permute4x64_epi64(x, 0xff);
+    }
+
+    template<int K>
+    ALA_TARGET("avx2") static type shl(type x) {
+        return _mm256_slli_epi64(x, K);
+    }
+
+    template<int K>
+    ALA_TARGET("avx2") static type shr(type x) {
+        return _mm256_srli_epi64(x, K);
+    }
+
+    // bits of the double in [0, 1) made of the high 52 bits of each lane
+    ALA_TARGET("avx2") static type unit_double(type x) {
+        const type one = _mm256_set1_epi64x(0x3ff0000000000000ll);
+        __m256d d = _mm256_castsi256_pd(
+            _mm256_or_si256(_mm256_srli_epi64(x, 12), one));
+        return _mm256_castpd_si256(_mm256_sub_pd(d, _mm256_castsi256_pd(one)));
+    }
+
+    // bits of two floats in [0, 1) per lane, one of the high 23 bits of
+    // each half
+    ALA_TARGET("avx2") static type unit_float(type x) {
+        const type one = _mm256_set1_epi32(0x3f800000);
+        __m256 f = _mm256_castsi256_ps(
+            _mm256_or_si256(_mm256_srli_epi32(x, 9), one));
+        return _mm256_castps_si256(_mm256_sub_ps(f, _mm256_castsi256_ps(one)));
+    }
+};
+
+template<class T>
+struct vec<T, 4, true>: _vec_base {
+    static constexpr size_t size = 8;
+
+    ALA_TARGET("avx2") static type set1(T v) {
+        return _mm256_castps_si256(_mm256_set1_ps(v));
+    }
+
+    ALA_TARGET("avx2") static type eq(type a, type b) {
+        return _mm256_castps_si256(_mm256_cmp_ps(
+            _mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+    }
+
+    ALA_TARGET("avx2") static type min(type a, type b) {
+        return _mm256_castps_si256(
+            _mm256_min_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    }
+
+    ALA_TARGET("avx2") static type max(type a, type b) {
+        return _mm256_castps_si256(
+            _mm256_max_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    }
+
+    ALA_TARGET("avx2") static type unord(type a) {
+        __m256 x = _mm256_castsi256_ps(a);
+        return _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+    }
+
+    ALA_TARGET("avx2") static type add(type a, type b) {
+        return _mm256_castps_si256(
+            _mm256_add_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    }
+
+    ALA_TARGET("avx2") static type mul(type a, type b) {
+        return _mm256_castps_si256(
+            _mm256_mul_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    }
+
+    // inclusive prefix sum of the lanes, in each half then across them
+    ALA_TARGET("avx2") static type prefix(type x) {
+        x = add(x, _mm256_slli_si256(x, 4));
+        x = add(x, _mm256_slli_si256(x, 8));
+        type t = _mm256_shuffle_epi32(x, 0xff);
+        return add(x, _mm256_permute2x128_si256(t, t, 0x08));
+    }
+
+    // lanes moved up by one, lane 0 cleared
+    ALA_TARGET("avx2") static type shift1(type x) {
+        return _mm256_alignr_epi8(x, _mm256_permute2x128_si256(x, x, 0x08),
+                                  12);
+    }
+
+    ALA_TARGET("avx2") static type bcast_last(type x) {
+        return _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+    }
+};
+
+template<class T>
+struct vec<T, 8, true>: _vec_base {
+    static constexpr size_t size = 4;
+
+    ALA_TARGET("avx2") static type set1(T v) {
+        return _mm256_castpd_si256(_mm256_set1_pd(v));
+    }
+
+    ALA_TARGET("avx2") static type eq(type a, type b) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(
+            _mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    }
+
+    ALA_TARGET("avx2") static type min(type a, type b) {
+        return _mm256_castpd_si256(
+            _mm256_min_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    }
+
+    ALA_TARGET("avx2") static type max(type a, type b) {
+        return _mm256_castpd_si256(
+            _mm256_max_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    }
+
+    ALA_TARGET("avx2") static type unord(type a) {
+        __m256d x = _mm256_castsi256_pd(a);
+        return _mm256_castpd_si256(_mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+    }
+
+    ALA_TARGET("avx2") static type add(type a, type b) {
+        return _mm256_castpd_si256(
+            _mm256_add_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    }
+
+    ALA_TARGET("avx2") static type mul(type a, type b) {
+        return _mm256_castpd_si256(
+            _mm256_mul_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    }
+
+    // inclusive prefix sum of the lanes, in each half then across them
+    ALA_TARGET("avx2") static type prefix(type x) {
+        x = add(x, _mm256_slli_si256(x, 8));
+        type t = _mm256_shuffle_epi32(x, 0xee);
+        return add(x, _mm256_permute2x128_si256(t, t, 0x08));
+    }
+
+    // lanes moved up by one, lane 0 cleared
+    ALA_TARGET("avx2") static type shift1(type x) {
+        return _mm256_alignr_epi8(x, _mm256_permute2x128_si256(x, x, 0x08),
+                                  8);
+    }
+
+    ALA_TARGET("avx2") static type bcast_last(type x) {
+        return _mm256_permute4x64_epi64(x, 0xff);
+    }
+};
+
+// Packing of the lanes selected by a bit mask to the low lanes, by lane
+// width. permutevar8x32 takes lane indices, packed three bits each in the
+// table, 8 byte lanes move as pairs of 4 byte lanes.
+struct _compress_lut_t {
+    unsigned v[256];
+};
+
+constexpr _compress_lut_t _make_compress_lut() {
+    _compress_lut_t t{};
+    for (unsigned m = 0; m != 256; ++m)
+        for (unsigned i = 0, k = 0; i != 8; ++i)
+            if (m >> i & 1)
+                t.v[m] |= i << (3 * k++);
+    return t;
+}
+
+template<class = void>
+struct _compress_lut {
+    static constexpr _compress_lut_t table = _make_compress_lut();
+};
+
+template<class Void>
+constexpr _compress_lut_t _compress_lut<Void>::table;
+
+template<size_t Size>
+struct _lanes;
+
+template<>
+struct _lanes<4> {
+    using type = __m256i;
+    static constexpr unsigned full = 0xff;
+
+    // one bit per lane of an all-ones or all-zeros lane mask
+    ALA_TARGET("avx2") static unsigned bits(type m) {
+        return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(m));
+    }
+
+    ALA_TARGET("avx2") static type compress(type x, unsigned m) {
+        const type shift = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+        type idx = _mm256_srlv_epi32(
+            _mm256_set1_epi32((int)_compress_lut<>::table.v[m]), shift);
+        return _mm256_permutevar8x32_epi32(x, idx);
+    }
+
+    // writes the low c lanes only
+    ALA_TARGET("avx2") static void store_first(void *p, type x, size_t c) {
+        const type lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        type m = _mm256_cmpgt_epi32(_mm256_set1_epi32((int)c), lane);
+        _mm256_maskstore_epi32((int *)p, m, x);
+    }
+};
+
+template<>
+struct _lanes<8> {
+    using type = __m256i;
+    static constexpr unsigned full = 0xf;
+
+    ALA_TARGET("avx2") static unsigned bits(type m) {
+        return (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(m));
+    }
+
+    ALA_TARGET("avx2") static type compress(type x, unsigned m) {
+        m = (m & 1) * 3 | (m & 2) * 6 | (m & 4) * 12 | (m & 8) * 24;
+        return _lanes<4>::compress(x, m);
+    }
+
+    ALA_TARGET("avx2") static void store_first(void *p, type x, size_t c) {
+        _lanes<4>::store_first(p, x, 2 * c);
+    }
+};
+
+} // namespace avx2
+
+// avx2 with the compress and masked stores of avx512vl
+namespace avx512 {
+
+using avx2::vec;
+
+template<size_t Size>
+struct _lanes;
+
+template<>
+struct _lanes<4>: avx2::_lanes<4> {
+    ALA_TARGET("avx512f,avx512vl") static type compress(type x, unsigned m) {
+        return _mm256_maskz_compress_epi32((__mmask8)m, x);
+    }
+
+    ALA_TARGET("avx512f,avx512vl")
+    static void store_first(void *p, type x, size_t c) {
+        _mm256_mask_storeu_epi32(p, (__mmask8)((1u << c) - 1), x);
+    }
+};
+
+template<>
+struct _lanes<8>: avx2::_lanes<8> {
+    ALA_TARGET("avx512f,avx512vl") static type compress(type x, unsigned m) {
+        return _mm256_maskz_compress_epi64((__mmask8)m, x);
+    }
+
+    ALA_TARGET("avx512f,avx512vl")
+    static void store_first(void *p, type x, size_t c) {
+        _mm256_mask_storeu_epi64(p, (__mmask8)((1u << c) - 1), x);
+    }
+};
+
+} // namespace avx512
+
+#endif // _ALA_SIMD_X86
+
+} // namespace intrin
+} // namespace ala
+
+#endif // HEAD
@@ -131,6 +131,15 @@ protected:
     template<class, class>
     friend class vector;
 
+    template<class, size_t, class>
+    friend class small_vector;
+
+    template<class, size_t>
+    friend class inplace_vector;
+
+    template<class>
+    friend class mirrored_ring;
+
     template<class, size_t>
     friend class span;
 
@@ -0,0 +1,93 @@
+#ifndef _ALA_DETAIL_SEGMENTED_ITERATOR_H
+#define _ALA_DETAIL_SEGMENTED_ITERATOR_H
+
+#include <ala/type_traits.h>
+
+namespace ala {
+
+// Iterators over a sequence of contiguous segments, the chunks of a
+// segmented_vector or a deque and the two laps of a ring. Algorithms split
+// [first, last) into pieces of local iterators, raw pointers, and run their
+// contiguous form on each. A segmented Iter specializes the traits with
+//   is_segmented_iterator = true_type
+//   segment_iterator        walks the segments, ++, == and !=
+//   local_iterator          position inside one segment
+//   segment(i), local(i)    the segment of i and the position of i in it
+//   begin(s), end(s)        the bounds of segment s
+//   compose(s, l)           the Iter at l in s, l may be end(s)
+// segment and local are only asked of dereferenceable iterators, the end of
+// a range is reached as local(prev(last)) + 1, so a container need not own
+// a segment past its last element.
+template<class Iter>
+struct segmented_iterator_traits {
+    using is_segmented_iterator = false_type;
+};
+
+template<class Iter>
+using _is_segmented_iter =
+    typename segmented_iterator_traits<Iter>::is_segmented_iterator;
+
+// Dispatch tag of algorithms that run their contiguous form per piece, it
+// takes the place of Tag for a segmented Iter
+struct _segmented_tag {};
+
+template<class Iter, class Tag>
+using _segmented_or_t =
+    conditional_t<_is_segmented_iter<Iter>::value, _segmented_tag, Tag>;
+
+template<class Iter>
+using _local_iter_t = typename segmented_iterator_traits<Iter>::local_iterator;
+
+// f(lfirst, llast) on each contiguous piece of [first, last) in order,
+// pieces are never empty
+template<class SegIter, class Fn>
+Fn for_each_segment(SegIter first, SegIter last, Fn f) {
+    using traits = segmented_iterator_traits<SegIter>;
+    if (first == last)
+        return f;
+    SegIter back = last;
+    --back;
+    auto sfirst = traits::segment(first);
+    auto slast = traits::segment(back);
+    auto llast = traits::local(back);
+    ++llast;
+    if (sfirst == slast) {
+        f(traits::local(first), llast);
+        return f;
+    }
+    f(traits::local(first), traits::end(sfirst));
+    for (++sfirst; sfirst != slast; ++sfirst)
+        f(traits::begin(sfirst), traits::end(sfirst));
+    f(traits::begin(slast), llast);
+    return f;
+}
+
+// f(lfirst, llast) on each piece until it returns a position short of
+// llast, the Iter at that position or last
+template<class SegIter, class Fn>
+SegIter _search_segments(SegIter first, SegIter last, Fn f) {
+    using traits = segmented_iterator_traits<SegIter>;
+    if (first == last)
+        return last;
+    SegIter back = last;
+    --back;
+    auto s = traits::segment(first);
+    auto slast = traits::segment(back);
+    auto lfirst = traits::local(first);
+    for (;; ++s, lfirst = traits::begin(s)) {
+        auto llast = traits::end(s);
+        if (s == slast) {
+            llast = traits::local(back);
+            ++llast;
+        }
+        auto i = f(lfirst, llast);
+        if (i != llast)
+            return traits::compose(s, i);
+        if (s == slast)
+            return last;
+    }
+}
+
+} // namespace ala
+
+#endif // HEAD
@@ -0,0 +1,167 @@
+#ifndef _ALA_DETAIL_SIMD_COMPACT_H
+#define _ALA_DETAIL_SIMD_COMPACT_H
+
+#include <ala/detail/intrin/simd.h>
+
+namespace ala {
+namespace intrin {
+
+// T from T * or const T *, inputs are mutable when the range is
+template<class P>
+using _pointee_t = remove_const_t<remove_pointer_t<P>>;
+
+#if _ALA_SIMD_X86
+
+namespace avx2 {
+    #define _ALA_SIMD_FN ALA_TARGET("avx2,popcnt") inline
+    #include <ala/detail/simd/compact.inc>
+    #undef _ALA_SIMD_FN
+} // namespace avx2
+
+namespace avx512 {
+    #define _ALA_SIMD_FN ALA_TARGET("avx2,popcnt,avx512f,avx512vl") inline
+    #include <ala/detail/simd/compact.inc>
+    #undef _ALA_SIMD_FN
+} // namespace avx512
+
+#endif
+
+// Without avx2 there is no lane shuffle to pack with, in place compaction
+// still stores every element and advances by the predicate, the exact ones
+// branch. Predicates see any trivially copyable T, only the lanes of 4 and
+// 8 byte ones are packed by vector.
+
+template<bool Exact, bool Want, class P, class Pred>
+inline _pointee_t<P> *_compact_if(P in, size_t n, _pointee_t<P> *out,
+                                  Pred &pred, false_type) {
+    for (size_t i = 0; i != n; ++i) {
+        bool keep = bool(pred(in[i])) == Want;
+        if (Exact) {
+            if (keep)
+                *out++ = in[i];
+        } else {
+            *out = in[i];
+            out += keep;
+        }
+    }
+    return out;
+}
+
+template<bool Exact, bool Want, class P, class Pred>
+inline _pointee_t<P> *_compact_if(P in, size_t n, _pointee_t<P> *out,
+                                  Pred &pred, true_type) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx512)
+        return ala::intrin::avx512::compact<Exact>(
+            in, n, out, avx512::_keep_if<Want, P, Pred>{pred});
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::compact<Exact>(
+            in, n, out, avx2::_keep_if<Want, P, Pred>{pred});
+#endif
+    return ala::intrin::_compact_if<Exact, Want>(in, n, out, pred,
+                                                 false_type{});
+}
+
+template<class T>
+struct _is_compact_lane: bool_constant<sizeof(T) == 4 || sizeof(T) == 8> {};
+
+// elements of in[0, n) where pred(x) == Want to out
+template<bool Exact, bool Want, class P, class Pred>
+inline _pointee_t<P> *simd_compact_if(P in, size_t n, _pointee_t<P> *out,
+                                      Pred &pred) {
+    using tag_t = _is_compact_lane<_pointee_t<P>>;
+    return ala::intrin::_compact_if<Exact, Want>(in, n, out, pred, tag_t{});
+}
+
+// The value compared ones take arithmetic T of 4 or 8 bytes
+
+// elements of in[0, n) not equal to value to out
+template<bool Exact, class P>
+inline _pointee_t<P> *simd_compact_ne(P in, size_t n, _pointee_t<P> *out,
+                                      _pointee_t<P> value) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx512)
+        return ala::intrin::avx512::compact<Exact>(
+            in, n, out, avx512::_keep_ne<P>{value});
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::compact<Exact>(in, n, out,
+                                                 avx2::_keep_ne<P>{value});
+#endif
+    for (size_t i = 0; i != n; ++i) {
+        bool keep = !(in[i] == value);
+        if (Exact) {
+            if (keep)
+                *out++ = in[i];
+        } else {
+            *out = in[i];
+            out += keep;
+        }
+    }
+    return out;
+}
+
+// elements of in[0, n) not equal to the one before them, in[-1] included
+template<bool Exact, class P>
+inline _pointee_t<P> *simd_compact_unique(P in, size_t n, _pointee_t<P> *out) {
+    _pointee_t<P> prev = in[-1];
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx512)
+        return ala::intrin::avx512::compact<Exact>(
+            in, n, out, avx512::_keep_unique<P>{prev});
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::compact<Exact>(in, n, out,
+                                                 avx2::_keep_unique<P>{prev});
+#endif
+    for (size_t i = 0; i != n; ++i) {
+        _pointee_t<P> x = in[i];
+        bool keep = !(x == prev);
+        prev = x;
+        if (Exact) {
+            if (keep)
+                *out++ = x;
+        } else {
+            *out = x;
+            out += keep;
+        }
+    }
+    return out;
+}
+
+template<class P, class Pred>
+inline void _partition_copy(P in, size_t n, _pointee_t<P> *&out_true,
+                            _pointee_t<P> *&out_false, Pred &pred,
+                            false_type) {
+    for (size_t i = 0; i != n; ++i)
+        if (pred(in[i]))
+            *out_true++ = in[i];
+        else
+            *out_false++ = in[i];
+}
+
+template<class P, class Pred>
+inline void _partition_copy(P in, size_t n, _pointee_t<P> *&out_true,
+                            _pointee_t<P> *&out_false, Pred &pred,
+                            true_type) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx512)
+        return ala::intrin::avx512::partition_copy(in, n, out_true, out_false,
+                                                   pred);
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::partition_copy(in, n, out_true, out_false,
+                                                 pred);
+#endif
+    ala::intrin::_partition_copy(in, n, out_true, out_false, pred,
+                                 false_type{});
+}
+
+template<class P, class Pred>
+inline void simd_partition_copy(P in, size_t n, _pointee_t<P> *&out_true,
+                                _pointee_t<P> *&out_false, Pred &pred) {
+    using tag_t = _is_compact_lane<_pointee_t<P>>;
+    ala::intrin::_partition_copy(in, n, out_true, out_false, pred, tag_t{});
+}
+
+} // namespace intrin
+} // namespace ala
+
+#endif // HEAD
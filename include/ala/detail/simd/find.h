@@ -0,0 +1,70 @@
+#ifndef _ALA_DETAIL_SIMD_FIND_H
+#define _ALA_DETAIL_SIMD_FIND_H
+
+#include <ala/detail/intrin/simd.h>
+
+namespace ala {
+namespace intrin {
+
+#if _ALA_SIMD_X86
+
+namespace sse2 {
+    #define _ALA_SIMD_FN inline
+    #include <ala/detail/simd/find.inc>
+    #undef _ALA_SIMD_FN
+} // namespace sse2
+
+namespace avx2 {
+    #define _ALA_SIMD_FN ALA_TARGET("avx2,popcnt") inline
+    #include <ala/detail/simd/find.inc>
+    #undef _ALA_SIMD_FN
+} // namespace avx2
+
+#endif
+
+template<bool Eq, class T>
+inline const T *simd_find(const T *first, const T *last, T value) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::find<Eq>(first, last, value);
+    return ala::intrin::sse2::find<Eq>(first, last, value);
+#else
+    for (; first != last; ++first)
+        if ((*first == value) == Eq)
+            return first;
+    return last;
+#endif
+}
+
+template<class T>
+inline size_t simd_count(const T *first, const T *last, T value) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::count(first, last, value);
+    return ala::intrin::sse2::count(first, last, value);
+#else
+    size_t n = 0;
+    for (; first != last; ++first)
+        n += *first == value;
+    return n;
+#endif
+}
+
+template<bool Eq, class T>
+inline size_t simd_mismatch(const T *a, const T *b, size_t n) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::mismatch<Eq>(a, b, n);
+    return ala::intrin::sse2::mismatch<Eq>(a, b, n);
+#else
+    for (size_t i = 0; i != n; ++i)
+        if ((a[i] == b[i]) == Eq)
+            return i;
+    return n;
+#endif
+}
+
+} // namespace intrin
+} // namespace ala
+
+#endif // HEAD
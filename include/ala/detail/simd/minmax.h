@@ -0,0 +1,51 @@
+#ifndef _ALA_DETAIL_SIMD_MINMAX_H
+#define _ALA_DETAIL_SIMD_MINMAX_H
+
+#include <ala/detail/simd/find.h>
+
+namespace ala {
+namespace intrin {
+
+#if _ALA_SIMD_X86
+
+namespace sse2 {
+    #define _ALA_SIMD_FN inline
+    #include <ala/detail/simd/minmax.inc>
+    #undef _ALA_SIMD_FN
+} // namespace sse2
+
+namespace avx2 {
+    #define _ALA_SIMD_FN ALA_TARGET("avx2,popcnt") inline
+    #include <ala/detail/simd/minmax.inc>
+    #undef _ALA_SIMD_FN
+} // namespace avx2
+
+#endif
+
+// The callers keep a scalar loop, these return false when they must run it
+template<bool Max, class T>
+inline bool simd_extremum_value(const T *p, size_t n, T &out) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::extremum_value<Max>(p, n, out);
+    return ala::intrin::sse2::extremum_value<Max>(p, n, out);
+#else
+    return false;
+#endif
+}
+
+template<bool Lo, bool Hi, bool LastHi, class T>
+inline bool simd_extremum(const T *p, size_t n, size_t &ilo, size_t &ihi) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::extremum<Lo, Hi, LastHi>(p, n, ilo, ihi);
+    return ala::intrin::sse2::extremum<Lo, Hi, LastHi>(p, n, ilo, ihi);
+#else
+    return false;
+#endif
+}
+
+} // namespace intrin
+} // namespace ala
+
+#endif // HEAD
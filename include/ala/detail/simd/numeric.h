@@ -0,0 +1,71 @@
+#ifndef _ALA_DETAIL_SIMD_NUMERIC_H
+#define _ALA_DETAIL_SIMD_NUMERIC_H
+
+#include <ala/detail/intrin/simd.h>
+
+namespace ala {
+namespace intrin {
+
+#if _ALA_SIMD_X86
+
+namespace sse2 {
+    #define _ALA_SIMD_FN inline
+    #include <ala/detail/simd/numeric.inc>
+    #undef _ALA_SIMD_FN
+} // namespace sse2
+
+namespace avx2 {
+    #define _ALA_SIMD_FN ALA_TARGET("avx2,popcnt") inline
+    #include <ala/detail/simd/numeric.inc>
+    #undef _ALA_SIMD_FN
+} // namespace avx2
+
+#endif
+
+// Elements of 4 or 8 bytes, dot takes floating point only
+template<class T>
+inline T simd_reduce(const T *p, size_t n, T init) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::reduce(p, n, init);
+    return ala::intrin::sse2::reduce(p, n, init);
+#else
+    for (size_t i = 0; i != n; ++i)
+        init += p[i];
+    return init;
+#endif
+}
+
+template<class T>
+inline T simd_dot(const T *a, const T *b, size_t n, T init) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::dot(a, b, n, init);
+    return ala::intrin::sse2::dot(a, b, n, init);
+#else
+    for (size_t i = 0; i != n; ++i)
+        init += a[i] * b[i];
+    return init;
+#endif
+}
+
+template<bool Inclusive, class T>
+inline T simd_scan(const T *in, size_t n, T *out, T init) {
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::scan<Inclusive>(in, n, out, init);
+    return ala::intrin::sse2::scan<Inclusive>(in, n, out, init);
+#else
+    for (size_t i = 0; i != n; ++i) {
+        T x = in[i];
+        out[i] = Inclusive ? init + x : init;
+        init += x;
+    }
+    return init;
+#endif
+}
+
+} // namespace intrin
+} // namespace ala
+
+#endif // HEAD
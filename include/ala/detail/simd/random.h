@@ -0,0 +1,52 @@
+#ifndef _ALA_DETAIL_SIMD_RANDOM_H
+#define _ALA_DETAIL_SIMD_RANDOM_H
+
+#include <ala/detail/intrin/simd.h>
+
+namespace ala {
+
+struct ScramberPlus;
+struct ScramberStarStar;
+struct ScramberPlusPlus;
+
+namespace intrin {
+
+#if _ALA_SIMD_X86
+
+namespace sse2 {
+    #define _ALA_SIMD_FN inline
+    #include <ala/detail/simd/random.inc>
+    #undef _ALA_SIMD_FN
+} // namespace sse2
+
+namespace avx2 {
+    #define _ALA_SIMD_FN ALA_TARGET("avx2") inline
+    #include <ala/detail/simd/random.inc>
+    #undef _ALA_SIMD_FN
+} // namespace avx2
+
+// Lanes interleaved xoshiro256 streams, see xoshiro_fill
+template<class Scramber, size_t Lanes, int Conv>
+inline void simd_xoshiro_fill(uint64_t *s, void *out, size_t n) {
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::xoshiro_fill<Scramber, Lanes, Conv>(s, out,
+                                                                      n);
+    ala::intrin::sse2::xoshiro_fill<Scramber, Lanes, Conv>(s, out, n);
+}
+
+// n Philox4x32 blocks, see philox4x32_fill
+template<size_t R, uint32_t M0, uint32_t C0, uint32_t M1, uint32_t C1>
+inline void simd_philox4x32_fill(const uint32_t *x, const uint32_t *k,
+                                 uint32_t *out, size_t n) {
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::philox4x32_fill<R, M0, C0, M1, C1>(x, k, out,
+                                                                     n);
+    ala::intrin::sse2::philox4x32_fill<R, M0, C0, M1, C1>(x, k, out, n);
+}
+
+#endif
+
+} // namespace intrin
+} // namespace ala
+
+#endif // HEAD
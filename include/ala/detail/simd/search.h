@@ -0,0 +1,49 @@
+#ifndef _ALA_DETAIL_SIMD_SEARCH_H
+#define _ALA_DETAIL_SIMD_SEARCH_H
+
+#include <ala/detail/simd/find.h>
+
+namespace ala {
+namespace intrin {
+
+#if _ALA_SIMD_X86
+
+namespace sse2 {
+    #define _ALA_SIMD_FN inline
+    #include <ala/detail/simd/search.inc>
+    #undef _ALA_SIMD_FN
+} // namespace sse2
+
+namespace avx2 {
+    #define _ALA_SIMD_FN ALA_TARGET("avx2,popcnt") inline
+    #include <ala/detail/simd/search.inc>
+    #undef _ALA_SIMD_FN
+} // namespace avx2
+
+#endif
+
+// first occurrence of pat[0, m) in s[0, n), n if none
+template<class T>
+inline size_t simd_search(const T *s, size_t n, const T *pat, size_t m) {
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return n;
+    if (m == 1)
+        return ala::intrin::simd_find<true>(s, s + n, pat[0]) - s;
+#if _ALA_SIMD_X86
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return ala::intrin::avx2::search(s, n, pat, m);
+    return ala::intrin::sse2::search(s, n, pat, m);
+#else
+    for (size_t i = 0; i + m <= n; ++i)
+        if (s[i] == pat[0] && ala::memcmp(s + i + 1, pat + 1, m - 1) == 0)
+            return i;
+    return n;
+#endif
+}
+
+} // namespace intrin
+} // namespace ala
+
+#endif // HEAD
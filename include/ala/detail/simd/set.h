@@ -0,0 +1,148 @@
+#ifndef _ALA_DETAIL_SIMD_SET_H
+#define _ALA_DETAIL_SIMD_SET_H
+
+#include <ala/detail/intrin/cpu_features.h>
+#include <ala/detail/intrin/simd.h>
+#include <ala/detail/utility_base.h>
+
+namespace ala {
+namespace intrin {
+
+#if _ALA_SIMD_X86
+
+namespace sse2 {
+    #define _ALA_SIMD_FN inline
+    #include <ala/detail/simd/set.inc>
+    #undef _ALA_SIMD_FN
+} // namespace sse2
+
+namespace avx2 {
+    #define _ALA_SIMD_FN ALA_TARGET("avx2,popcnt") inline
+    #include <ala/detail/simd/set.inc>
+    #undef _ALA_SIMD_FN
+} // namespace avx2
+
+template<class T>
+using _set_op_t = T *(*)(const T *, size_t, const T *, size_t, T *);
+
+// The kernel of each operation and T is picked once by simd_level(),
+// resolve_once keeps the pointer
+template<class T>
+inline _set_op_t<T> _resolve_set_intersection() {
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return &ala::intrin::avx2::set_intersection<T>;
+    return &ala::intrin::sse2::set_intersection<T>;
+}
+
+template<class T>
+inline _set_op_t<T> _resolve_set_difference() {
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return &ala::intrin::avx2::set_difference<T>;
+    return &ala::intrin::sse2::set_difference<T>;
+}
+
+template<class T>
+inline _set_op_t<T> _resolve_set_union() {
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return &ala::intrin::avx2::set_union<T>;
+    return &ala::intrin::sse2::set_union<T>;
+}
+
+template<class T>
+using _includes_t = bool (*)(const T *, size_t, const T *, size_t);
+
+template<class T>
+inline _includes_t<T> _resolve_includes() {
+    if (ala::intrin::simd_level() >= simd_avx2)
+        return &ala::intrin::avx2::includes<T>;
+    return &ala::intrin::sse2::includes<T>;
+}
+
+#endif
+
+// Integers of 4 or 8 bytes, other targets keep the plain merges
+template<class T>
+inline T *simd_set_intersection(const T *a, size_t na, const T *b, size_t nb,
+                                T *out) {
+#if _ALA_SIMD_X86
+    using fp = _set_op_t<T>;
+    fp f = ala::intrin::resolve_once<fp, &_resolve_set_intersection<T>>();
+    return f(a, na, b, nb, out);
+#else
+    size_t i = 0, j = 0;
+    while (i != na && j != nb) {
+        T x = a[i], y = b[j];
+        if (x == y)
+            *out++ = x;
+        i += x <= y;
+        j += y <= x;
+    }
+    return out;
+#endif
+}
+
+template<class T>
+inline T *simd_set_difference(const T *a, size_t na, const T *b, size_t nb,
+                              T *out) {
+#if _ALA_SIMD_X86
+    using fp = _set_op_t<T>;
+    fp f = ala::intrin::resolve_once<fp, &_resolve_set_difference<T>>();
+    return f(a, na, b, nb, out);
+#else
+    size_t i = 0, j = 0;
+    while (i != na && j != nb) {
+        T x = a[i], y = b[j];
+        if (x < y)
+            *out++ = x;
+        i += x <= y;
+        j += y <= x;
+    }
+    for (; i != na; ++i)
+        *out++ = a[i];
+    return out;
+#endif
+}
+
+template<class T>
+inline T *simd_set_union(const T *a, size_t na, const T *b, size_t nb,
+                         T *out) {
+#if _ALA_SIMD_X86
+    using fp = _set_op_t<T>;
+    fp f = ala::intrin::resolve_once<fp, &_resolve_set_union<T>>();
+    return f(a, na, b, nb, out);
+#else
+    size_t i = 0, j = 0;
+    while (i != na && j != nb) {
+        T x = a[i], y = b[j];
+        *out++ = y < x ? y : x;
+        i += x <= y;
+        j += y <= x;
+    }
+    for (; i != na; ++i)
+        *out++ = a[i];
+    for (; j != nb; ++j)
+        *out++ = b[j];
+    return out;
+#endif
+}
+
+template<class T>
+inline bool simd_includes(const T *a, size_t na, const T *b, size_t nb) {
+#if _ALA_SIMD_X86
+    using fp = _includes_t<T>;
+    fp f = ala::intrin::resolve_once<fp, &_resolve_includes<T>>();
+    return f(a, na, b, nb);
+#else
+    for (size_t i = 0, j = 0; j != nb; ++i) {
+        if (i == na || b[j] < a[i])
+            return false;
+        j += a[i] == b[j];
+    }
+    return true;
+#endif
+}
+
+} // namespace intrin
+} // namespace ala
+
+#endif // HEAD
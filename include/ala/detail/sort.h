@@ -359,7 +359,7 @@ constexpr void quick_sort_impl(RandomIter first, RandomIter last, Comp comp) {
 template<class RandomIter, class Comp>
 constexpr void heap_sort(RandomIter first, RandomIter last, Comp comp);
 
-template<class RandomIter, class Comp>
+template<class RandomIter>
 constexpr void break_pattern(RandomIter first, RandomIter last) {
     using diff_t = typename iterator_traits<RandomIter>::difference_type;
     diff_t len = last - first;
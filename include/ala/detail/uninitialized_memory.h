@@ -4,10 +4,60 @@
 #include <ala/config.h>
 #include <ala/detail/pair.h>
 #include <ala/detail/memory_base.h>
+#include <ala/detail/segmented_iterator.h>
 #include <ala/iterator.h>
 
 namespace ala {
 
+// Contiguous ranges of trivially copyable values, constructed and copied as
+// bytes. Copies of such values have no effects beyond their bytes and can
+// not throw, so the loops below lower to memmove and memset.
+template<class Iter, class Ref = typename iterator_traits<Iter>::reference,
+         class T = remove_cv_t<remove_reference_t<Ref>>>
+struct _is_bitwise_iter
+    : bool_constant<(is_pointer<Iter>::value ||
+                     is_base_of<contiguous_iterator_tag,
+                                _iter_concept_t<Iter>>::value) &&
+                    is_lvalue_reference<Ref>::value &&
+                    !is_volatile<remove_reference_t<Ref>>::value &&
+                    is_trivially_copyable<T>::value> {};
+
+template<class Iter>
+using _bitwise_value_t =
+    remove_cv_t<remove_reference_t<typename iterator_traits<Iter>::reference>>;
+
+template<class Iter1, class Iter2>
+struct _is_bitwise_iter2
+    : _and_<_is_bitwise_iter<Iter1>, _is_bitwise_iter<Iter2>,
+            is_same<_bitwise_value_t<Iter1>, _bitwise_value_t<Iter2>>> {};
+
+// x to n values at p, a memset if its bytes are all the same, zero for most
+// value initialized ones
+template<class T>
+void _bitwise_fill(T *p, size_t n, const T &x) {
+    const unsigned char *b = reinterpret_cast<const unsigned char *>(&x);
+    bool same = true;
+    for (size_t i = 1; i != sizeof(T); ++i)
+        same &= b[i] == b[0];
+    if (same) {
+        if (n != 0)
+            ala::memset(static_cast<void *>(p), b[0], n * sizeof(T));
+        return;
+    }
+    for (size_t i = 0; i != n; ++i)
+        ala::memcpy(static_cast<void *>(p + i), &x, sizeof(T));
+}
+
+template<class InputIter, class ForwardIter>
+ForwardIter _bitwise_copy(InputIter first, size_t n, ForwardIter out) {
+    using T = _bitwise_value_t<ForwardIter>;
+    if (n != 0)
+        ala::memmove(static_cast<void *>(ala::to_address(out)),
+                     static_cast<const void *>(ala::to_address(first)),
+                     n * sizeof(T));
+    return out + n;
+}
+
 template<class ForwardIter>
 constexpr void destroy(ForwardIter first, ForwardIter last) {
     for (; first != last; ++first)
@@ -22,12 +72,12 @@ ForwardIter destroy_n(ForwardIter first, Size count) {
     return first;
 }
 
-template<class ForwardIter>
-void uninitialized_default_construct(ForwardIter first, ForwardIter last) {
+template<class ForwardIter, class Size>
+ForwardIter _default_construct_n(ForwardIter first, Size n, false_type) {
     using T = typename iterator_traits<ForwardIter>::value_type;
     ForwardIter i = first;
     try {
-        for (; i != last; ++i)
+        for (; n > 0; ++i, (void)--n)
             ::new (ala::_voidify(*i)) T;
     } catch (...) {
         ala::destroy(first, i);
@@ -36,14 +86,35 @@ void uninitialized_default_construct(ForwardIter first, ForwardIter last) {
     return i;
 }
 
+// trivial default initialization leaves the bytes as they are
+template<class ForwardIter, class Size>
+ForwardIter _default_construct_n(ForwardIter first, Size n, true_type) {
+    return ala::next(first, n);
+}
+
+template<class ForwardIter>
+void uninitialized_default_construct(ForwardIter first, ForwardIter last) {
+    using T = typename iterator_traits<ForwardIter>::value_type;
+    if (is_trivially_default_constructible<T>::value)
+        return;
+    ala::_default_construct_n(first, ala::distance(first, last), false_type{});
+}
+
 template<class ForwardIter, class Size>
 ForwardIter uninitialized_default_construct_n(ForwardIter first, Size count) {
     using T = typename iterator_traits<ForwardIter>::value_type;
     auto n = ala::_convert_to_integral(count);
+    return ala::_default_construct_n(
+        first, n, is_trivially_default_constructible<T>{});
+}
+
+template<class ForwardIter, class Size>
+ForwardIter _value_construct_n(ForwardIter first, Size n, false_type) {
+    using T = typename iterator_traits<ForwardIter>::value_type;
     ForwardIter i = first;
     try {
         for (; n > 0; ++i, (void)--n)
-            ::new (ala::_voidify(*i)) T;
+            ::new (ala::_voidify(*i)) T();
     } catch (...) {
         ala::destroy(first, i);
         throw;
@@ -51,28 +122,40 @@ ForwardIter uninitialized_default_construct_n(ForwardIter first, Size count) {
     return i;
 }
 
+// a value initialized trivial T is a copy of T()
+template<class ForwardIter, class Size>
+ForwardIter _value_construct_n(ForwardIter first, Size n, true_type) {
+    using T = _bitwise_value_t<ForwardIter>;
+    size_t len = n > 0 ? static_cast<size_t>(n) : 0;
+    ala::_bitwise_fill(ala::to_address(first), len, T());
+    return first + len;
+}
+
+template<class ForwardIter>
+using _is_bitwise_value_iter =
+    _and_<_is_bitwise_iter<ForwardIter>,
+          is_trivial<_bitwise_value_t<ForwardIter>>>;
+
 template<class ForwardIter>
 void uninitialized_value_construct(ForwardIter first, ForwardIter last) {
-    using T = typename iterator_traits<ForwardIter>::value_type;
-    ForwardIter i = first;
-    try {
-        for (; i != last; ++i)
-            ::new (ala::_voidify(*i)) T();
-    } catch (...) {
-        ala::destroy(first, i);
-        throw;
-    }
-    return i;
+    ala::_value_construct_n(first, ala::distance(first, last),
+                            _is_bitwise_value_iter<ForwardIter>{});
 }
 
 template<class ForwardIter, class Size>
 ForwardIter uninitialized_value_construct_n(ForwardIter first, Size count) {
-    using T = typename iterator_traits<ForwardIter>::value_type;
     auto n = ala::_convert_to_integral(count);
+    return ala::_value_construct_n(first, n,
+                                   _is_bitwise_value_iter<ForwardIter>{});
+}
+
+template<class ForwardIter, class Size, class T>
+ForwardIter _fill_n(ForwardIter first, Size n, const T &x, false_type) {
+    using V = typename iterator_traits<ForwardIter>::value_type;
     ForwardIter i = first;
     try {
         for (; n > 0; ++i, (void)--n)
-            ::new (ala::_voidify(*i)) T();
+            ::new (ala::_voidify(*i)) V(x);
     } catch (...) {
         ala::destroy(first, i);
         throw;
@@ -80,40 +163,64 @@ ForwardIter uninitialized_value_construct_n(ForwardIter first, Size count) {
     return i;
 }
 
+template<class ForwardIter, class Size, class T>
+ForwardIter _fill_n(ForwardIter first, Size n, const T &x, true_type) {
+    size_t len = n > 0 ? static_cast<size_t>(n) : 0;
+    ala::_bitwise_fill(ala::to_address(first), len, x);
+    return first + len;
+}
+
+// x of the value type itself, a conversion would run once instead of per
+// element
+template<class ForwardIter, class T>
+using _is_bitwise_fill =
+    _and_<_is_bitwise_iter<ForwardIter>,
+          is_same<_bitwise_value_t<ForwardIter>, remove_cv_t<T>>>;
+
 template<class ForwardIter, class T>
 void uninitialized_fill(ForwardIter first, ForwardIter last, const T &x) {
-    ForwardIter i = first;
-    try {
-        for (; i != last; ++i)
-            ::new (ala::_voidify(*i)) T(x);
-    } catch (...) {
-        ala::destroy(first, i);
-        throw;
-    }
-    return i;
+    ala::_fill_n(first, ala::distance(first, last), x,
+                 _is_bitwise_fill<ForwardIter, T>{});
 }
 
 template<class ForwardIter, class Size, class T>
 ForwardIter uninitialized_fill_n(ForwardIter first, Size count, const T &x) {
     auto n = ala::_convert_to_integral(count);
-    ForwardIter i = first;
+    return ala::_fill_n(first, n, x, _is_bitwise_fill<ForwardIter, T>{});
+}
+
+template<class InputIter, class ForwardIter>
+ForwardIter _uninit_copy(InputIter first, InputIter last, ForwardIter out,
+                         false_type) {
+    using T = typename iterator_traits<ForwardIter>::value_type;
+    ForwardIter i = out;
     try {
-        for (; n > 0; ++i, (void)--n)
-            ::new (ala::_voidify(*i)) T(x);
+        for (; first != last; ++first, (void)++i)
+            ::new (ala::_voidify(*i)) T(*first);
     } catch (...) {
-        ala::destroy(first, i);
+        ala::destroy(out, i);
         throw;
     }
     return i;
 }
 
 template<class InputIter, class ForwardIter>
-ForwardIter uninitialized_copy(InputIter first, InputIter last, ForwardIter out) {
-    using T = typename iterator_traits<ForwardIter>::value_type;
+ForwardIter _uninit_copy(InputIter first, InputIter last, ForwardIter out,
+                         true_type) {
+    return ala::_bitwise_copy(first, last - first, out);
+}
+
+// each piece with its own form, the pieces done are destroyed on a throw
+template<class InputIter, class ForwardIter>
+ForwardIter _uninit_copy(InputIter first, InputIter last, ForwardIter out,
+                         _segmented_tag) {
+    using local_t = _local_iter_t<InputIter>;
+    using tag_t = _is_bitwise_iter2<local_t, ForwardIter>;
     ForwardIter i = out;
     try {
-        for (; first != last; ++first, (void)++i)
-            ::new (ala::_voidify(*i)) T(*first);
+        ala::for_each_segment(first, last, [&](local_t l, local_t r) {
+            i = ala::_uninit_copy(l, r, i, tag_t{});
+        });
     } catch (...) {
         ala::destroy(out, i);
         throw;
@@ -121,10 +228,18 @@ ForwardIter uninitialized_copy(InputIter first, InputIter last, ForwardIter out)
     return i;
 }
 
+template<class InputIter, class ForwardIter>
+ForwardIter uninitialized_copy(InputIter first, InputIter last,
+                               ForwardIter out) {
+    using tag_t = _is_bitwise_iter2<InputIter, ForwardIter>;
+    return ala::_uninit_copy(first, last, out,
+                             _segmented_or_t<InputIter, tag_t>{});
+}
+
 template<class InputIter, class Size, class ForwardIter>
-ForwardIter uninitialized_copy_n(InputIter first, Size count, ForwardIter out) {
+ForwardIter _uninit_copy_n(InputIter first, Size n, ForwardIter out,
+                           false_type) {
     using T = typename iterator_traits<ForwardIter>::value_type;
-    auto n = ala::_convert_to_integral(count);
     ForwardIter i = out;
     try {
         for (; n > 0; ++i, ++first, (void)--n)
@@ -136,8 +251,22 @@ ForwardIter uninitialized_copy_n(InputIter first, Size count, ForwardIter out) {
     return i;
 }
 
+template<class InputIter, class Size, class ForwardIter>
+ForwardIter _uninit_copy_n(InputIter first, Size n, ForwardIter out,
+                           true_type) {
+    return ala::_bitwise_copy(first, n > 0 ? static_cast<size_t>(n) : 0, out);
+}
+
+template<class InputIter, class Size, class ForwardIter>
+ForwardIter uninitialized_copy_n(InputIter first, Size count, ForwardIter out) {
+    auto n = ala::_convert_to_integral(count);
+    return ala::_uninit_copy_n(first, n, out,
+                               _is_bitwise_iter2<InputIter, ForwardIter>{});
+}
+
 template<class InputIter, class ForwardIter>
-ForwardIter uninitialized_move(InputIter first, InputIter last, ForwardIter out) {
+ForwardIter _uninit_move(InputIter first, InputIter last, ForwardIter out,
+                         false_type) {
     using T = typename iterator_traits<ForwardIter>::value_type;
     ForwardIter i = out;
     try {
@@ -150,11 +279,41 @@ ForwardIter uninitialized_move(InputIter first, InputIter last, ForwardIter out)
     return i;
 }
 
+template<class InputIter, class ForwardIter>
+ForwardIter _uninit_move(InputIter first, InputIter last, ForwardIter out,
+                         true_type) {
+    return ala::_bitwise_copy(first, last - first, out);
+}
+
+template<class InputIter, class ForwardIter>
+ForwardIter _uninit_move(InputIter first, InputIter last, ForwardIter out,
+                         _segmented_tag) {
+    using local_t = _local_iter_t<InputIter>;
+    using tag_t = _is_bitwise_iter2<local_t, ForwardIter>;
+    ForwardIter i = out;
+    try {
+        ala::for_each_segment(first, last, [&](local_t l, local_t r) {
+            i = ala::_uninit_move(l, r, i, tag_t{});
+        });
+    } catch (...) {
+        ala::destroy(out, i);
+        throw;
+    }
+    return i;
+}
+
+template<class InputIter, class ForwardIter>
+ForwardIter uninitialized_move(InputIter first, InputIter last,
+                               ForwardIter out) {
+    using tag_t = _is_bitwise_iter2<InputIter, ForwardIter>;
+    return ala::_uninit_move(first, last, out,
+                             _segmented_or_t<InputIter, tag_t>{});
+}
+
 template<class InputIter, class Size, class ForwardIter>
-pair<InputIter, ForwardIter> uninitialized_move_n(InputIter first, Size count,
-                                                  ForwardIter out) {
+pair<InputIter, ForwardIter> _uninit_move_n(InputIter first, Size n,
+                                            ForwardIter out, false_type) {
     using T = typename iterator_traits<ForwardIter>::value_type;
-    auto n = ala::_convert_to_integral(count);
     ForwardIter i = out;
     try {
         for (; n > 0; ++i, ++first, (void)--n)
@@ -163,7 +322,23 @@ pair<InputIter, ForwardIter> uninitialized_move_n(InputIter first, Size count,
         ala::destroy(out, i);
         throw;
     }
-    return i;
+    return pair<InputIter, ForwardIter>(first, i);
+}
+
+template<class InputIter, class Size, class ForwardIter>
+pair<InputIter, ForwardIter> _uninit_move_n(InputIter first, Size n,
+                                            ForwardIter out, true_type) {
+    size_t len = n > 0 ? static_cast<size_t>(n) : 0;
+    return pair<InputIter, ForwardIter>(first + len,
+                                        ala::_bitwise_copy(first, len, out));
+}
+
+template<class InputIter, class Size, class ForwardIter>
+pair<InputIter, ForwardIter> uninitialized_move_n(InputIter first, Size count,
+                                                  ForwardIter out) {
+    auto n = ala::_convert_to_integral(count);
+    return ala::_uninit_move_n(first, n, out,
+                               _is_bitwise_iter2<InputIter, ForwardIter>{});
 }
 
 } // namespace ala
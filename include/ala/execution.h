@@ -0,0 +1,76 @@
+#ifndef _ALA_EXECUTION_H
+#define _ALA_EXECUTION_H
+
+#include <ala/type_traits.h>
+#include <ala/vector.h>
+
+#include <thread>
+
+namespace ala {
+namespace execution {
+
+struct sequenced_policy {};
+struct parallel_policy {};
+struct parallel_unsequenced_policy {};
+struct unsequenced_policy {};
+
+ALA_INLINE_CONSTEXPR_V sequenced_policy seq{};
+ALA_INLINE_CONSTEXPR_V parallel_policy par{};
+ALA_INLINE_CONSTEXPR_V parallel_unsequenced_policy par_unseq{};
+ALA_INLINE_CONSTEXPR_V unsequenced_policy unseq{};
+
+} // namespace execution
+
+template<class T>
+struct is_execution_policy: false_type {};
+
+template<>
+struct is_execution_policy<execution::sequenced_policy>: true_type {};
+
+template<>
+struct is_execution_policy<execution::parallel_policy>: true_type {};
+
+template<>
+struct is_execution_policy<execution::parallel_unsequenced_policy>
+    : true_type {};
+
+template<>
+struct is_execution_policy<execution::unsequenced_policy>: true_type {};
+
+template<class T>
+ALA_INLINE_CONSTEXPR_V bool is_execution_policy_v =
+    is_execution_policy<T>::value;
+
+// Policies that may spread work over threads
+template<class T>
+struct _is_parallel_policy
+    : bool_constant<is_same<T, execution::parallel_policy>::value ||
+                    is_same<T, execution::parallel_unsequenced_policy>::value> {
+};
+
+// Blocks of at least grain elements, no more than hardware threads
+inline size_t _parallel_block_count(size_t n, size_t grain) {
+    size_t hw = std::thread::hardware_concurrency();
+    size_t k = n / grain;
+    if (hw == 0)
+        hw = 1;
+    return k < 1 ? 1 : k < hw ? k : hw;
+}
+
+// Calls fn(i, begin, end) for k contiguous blocks of [0, n), block 0 on the
+// calling thread. An exception escaping fn terminates, as with std::par.
+template<class Fn>
+void _parallel_blocks(size_t n, size_t k, Fn &fn) noexcept {
+    vector<std::thread> threads;
+    threads.reserve(k - 1);
+    for (size_t i = 1; i < k; ++i)
+        threads.emplace_back(
+            [&fn, n, k, i] { fn(i, n * i / k, n * (i + 1) / k); });
+    fn(0, 0, n / k);
+    for (std::thread &t : threads)
+        t.join();
+}
+
+} // namespace ala
+
+#endif // HEAD
@@ -889,4 +889,212 @@ private:
 };
 
 } // namespace ala
+
+#if ALA_LANG >= 201703L
+
+    // includes ala/functional.h back, everything it needs is declared above
+    #include <ala/detail/impl/unordered_dense.h>
+
+namespace ala {
+
+// Bad character table, bytes compared by equal_to index an array, larger
+// alphabets go to a dense hash map
+template<class Key, class Value, class Hash, class BinPred,
+         bool = is_integral<Key>::value && sizeof(Key) == 1 &&
+                is_same<Hash, hash<Key>>::value &&
+                _is_simd_equal_to<BinPred, Key>::value>
+class _skip_table {
+public:
+    _skip_table(size_t, Value value, const Hash &, const BinPred &) {
+        ala::fill(_table, _table + 256, value);
+    }
+
+    void insert(const Key &key, Value value) {
+        _table[static_cast<unsigned char>(key)] = value;
+    }
+
+    Value operator[](const Key &key) const {
+        return _table[static_cast<unsigned char>(key)];
+    }
+
+private:
+    Value _table[256];
+};
+
+template<class Key, class Value, class Hash, class BinPred>
+class _skip_table<Key, Value, Hash, BinPred, false> {
+public:
+    _skip_table(size_t n, Value value, const Hash &hf, const BinPred &pred)
+        : _default(value), _table(n, hf, pred) {}
+
+    void insert(const Key &key, Value value) {
+        _table.insert_or_assign(key, value);
+    }
+
+    Value operator[](const Key &key) const {
+        auto it = _table.find(key);
+        return it == _table.end() ? _default : it->second;
+    }
+
+private:
+    Value _default;
+    ankerl::unordered_dense::map<Key, Value, Hash, BinPred> _table;
+};
+
+template<class RandomIter,
+         class Hash = hash<typename iterator_traits<RandomIter>::value_type>,
+         class BinPred = equal_to<>>
+class boyer_moore_searcher {
+    using value_type = typename iterator_traits<RandomIter>::value_type;
+    using diff_t = typename iterator_traits<RandomIter>::difference_type;
+
+public:
+    boyer_moore_searcher(RandomIter pat_first, RandomIter pat_last,
+                         Hash hf = Hash(), BinPred pred = BinPred())
+        : _pat_first(pat_first), _pat_last(pat_last), _pred(pred),
+          _skip(pat_last - pat_first, -1, hf, pred),
+          _suffix(pat_last - pat_first + 1) {
+        diff_t m = pat_last - pat_first;
+        for (diff_t i = 0; i < m; ++i)
+            _skip.insert(pat_first[i], i);
+        this->build_suffix();
+    }
+
+    template<class RandomIter1>
+    pair<RandomIter1, RandomIter1> operator()(RandomIter1 first,
+                                              RandomIter1 last) const {
+        diff_t m = _pat_last - _pat_first;
+        if (m == 0)
+            return pair<RandomIter1, RandomIter1>(first, first);
+        if (last - first < m)
+            return pair<RandomIter1, RandomIter1>(last, last);
+        for (RandomIter1 cur = first, end = last - m; cur <= end;) {
+            diff_t j = m;
+            while (_pred(_pat_first[j - 1], cur[j - 1]))
+                if (--j == 0)
+                    return pair<RandomIter1, RandomIter1>(cur, cur + m);
+            diff_t k = _skip[cur[j - 1]];
+            diff_t bad = j - k - 1;
+            cur += k < j && bad > _suffix[j] ? bad : _suffix[j];
+        }
+        return pair<RandomIter1, RandomIter1>(last, last);
+    }
+
+private:
+    RandomIter _pat_first;
+    RandomIter _pat_last;
+    BinPred _pred;
+    _skip_table<value_type, diff_t, Hash, BinPred> _skip;
+    vector<diff_t> _suffix;
+
+    // border lengths of every prefix of [first, first + m)
+    template<class Iter>
+    void prefix(Iter first, diff_t m, vector<diff_t> &border) const {
+        border[0] = 0;
+        for (diff_t i = 1, k = 0; i < m; ++i) {
+            while (k > 0 && !_pred(first[k], first[i]))
+                k = border[k - 1];
+            if (_pred(first[k], first[i]))
+                ++k;
+            border[i] = k;
+        }
+    }
+
+    // _suffix[j] is the good suffix shift when pattern [j, m) has matched
+    void build_suffix() {
+        diff_t m = _pat_last - _pat_first;
+        if (m == 0)
+            return;
+        vector<diff_t> border(m);
+        this->prefix(_pat_first, m, border);
+        for (diff_t j = 0; j <= m; ++j)
+            _suffix[j] = m - border[m - 1];
+        this->prefix(ala::make_reverse_iterator(_pat_last), m, border);
+        for (diff_t i = 0; i < m; ++i) {
+            diff_t j = m - border[i];
+            diff_t k = i - border[i] + 1;
+            if (_suffix[j] > k)
+                _suffix[j] = k;
+        }
+    }
+};
+
+template<class RandomIter,
+         class Hash = hash<typename iterator_traits<RandomIter>::value_type>,
+         class BinPred = equal_to<>>
+class boyer_moore_horspool_searcher {
+    using value_type = typename iterator_traits<RandomIter>::value_type;
+    using diff_t = typename iterator_traits<RandomIter>::difference_type;
+
+public:
+    boyer_moore_horspool_searcher(RandomIter pat_first, RandomIter pat_last,
+                                  Hash hf = Hash(), BinPred pred = BinPred())
+        : _pat_first(pat_first), _pat_last(pat_last), _pred(pred),
+          _skip(pat_last - pat_first, pat_last - pat_first, hf, pred) {
+        diff_t m = pat_last - pat_first;
+        for (diff_t i = 0; i + 1 < m; ++i)
+            _skip.insert(pat_first[i], m - 1 - i);
+    }
+
+    template<class RandomIter1>
+    pair<RandomIter1, RandomIter1> operator()(RandomIter1 first,
+                                              RandomIter1 last) const {
+        diff_t m = _pat_last - _pat_first;
+        if (m == 0)
+            return pair<RandomIter1, RandomIter1>(first, first);
+        if (last - first < m)
+            return pair<RandomIter1, RandomIter1>(last, last);
+        for (RandomIter1 cur = first, end = last - m; cur <= end;) {
+            diff_t j = m;
+            while (_pred(_pat_first[j - 1], cur[j - 1]))
+                if (--j == 0)
+                    return pair<RandomIter1, RandomIter1>(cur, cur + m);
+            cur += _skip[cur[m - 1]];
+        }
+        return pair<RandomIter1, RandomIter1>(last, last);
+    }
+
+private:
+    RandomIter _pat_first;
+    RandomIter _pat_last;
+    BinPred _pred;
+    _skip_table<value_type, diff_t, Hash, BinPred> _skip;
+};
+
+// Contiguous byte ranges only, candidates are filtered on the first and the
+// last byte of the pattern a vector at a time, see ala::intrin::simd_search
+template<class ContiguousIter>
+class simd_searcher {
+    using value_type = _simd_value_t<ContiguousIter>;
+    static_assert(_is_simd_iter<ContiguousIter>::value &&
+                      is_integral<value_type>::value && sizeof(value_type) == 1,
+                  "ala::simd_searcher need contiguous range of bytes");
+
+public:
+    simd_searcher(ContiguousIter pat_first, ContiguousIter pat_last)
+        : _pat_first(pat_first), _pat_last(pat_last) {}
+
+    template<class ContiguousIter1>
+    pair<ContiguousIter1, ContiguousIter1>
+    operator()(ContiguousIter1 first, ContiguousIter1 last) const {
+        static_assert(_is_simd_iter2<ContiguousIter, ContiguousIter1>::value,
+                      "ala::simd_searcher need same value type");
+        size_t n = last - first, m = _pat_last - _pat_first;
+        size_t i = ala::intrin::simd_search(ala::to_address(first), n,
+                                            ala::to_address(_pat_first), m);
+        if (i == n)
+            return pair<ContiguousIter1, ContiguousIter1>(last, last);
+        return pair<ContiguousIter1, ContiguousIter1>(first + i,
+                                                      first + i + m);
+    }
+
+private:
+    ContiguousIter _pat_first;
+    ContiguousIter _pat_last;
+};
+
+} // namespace ala
+
+#endif
+
 #endif
\ No newline at end of file
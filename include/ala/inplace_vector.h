@@ -0,0 +1,665 @@
+#ifndef _ALA_INPLACE_VECTOR_H
+#define _ALA_INPLACE_VECTOR_H
+
+#include <ala/detail/algorithm_base.h>
+#include <ala/detail/allocator.h>
+#include <ala/detail/ptr_iterator.h>
+
+namespace ala {
+
+// the narrowest unsigned type that holds N
+template<size_t N>
+using _inplace_size_t = conditional_t<
+    (N <= 0xff), uint8_t,
+    conditional_t<(N <= 0xffff), uint16_t,
+                  conditional_t<(N <= 0xffffffff), uint32_t, size_t>>>;
+
+// The size followed by room for N elements, nothing else. Trivial T is kept
+// as T[N] and the whole storage is trivially copyable, it can be copied as
+// bytes into shared memory or a message slot, and used in constant
+// expressions.
+template<class T, size_t N, bool = is_trivial<T>::value>
+struct _inplace_storage {
+    _inplace_size_t<N> _size = 0;
+#if _ALA_CONSTEXPR_VER >= 20 && _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    T _buf[N ? N : 1];
+
+    // a constant result can not hold indeterminate values
+    constexpr _inplace_storage() noexcept {
+        if (ala::is_constant_evaluated())
+            for (T &x : _buf)
+                x = T();
+    }
+#else
+    T _buf[N ? N : 1] = {};
+#endif
+
+    constexpr T *_ptr() noexcept {
+        return _buf;
+    }
+
+    constexpr const T *_ptr() const noexcept {
+        return _buf;
+    }
+};
+
+template<class T, size_t N>
+struct _inplace_storage<T, N, false> {
+    _inplace_size_t<N> _size = 0;
+    alignas(T) unsigned char _buf[(N ? N : 1) * sizeof(T)];
+
+    T *_ptr() noexcept {
+        return reinterpret_cast<T *>(_buf);
+    }
+
+    const T *_ptr() const noexcept {
+        return reinterpret_cast<const T *>(_buf);
+    }
+
+    // the common prefix assigned, the rest constructed or destroyed
+    template<class Iter>
+    void _assign(Iter first, size_t n) {
+        T *p = this->_ptr();
+        size_t k = n < _size ? n : _size;
+        for (size_t i = 0; i != k; ++i, (void)++first)
+            p[i] = *first;
+        if (n > _size)
+            ala::uninitialized_copy_n(first, n - k, p + k);
+        else
+            ala::destroy(p + n, p + _size);
+        _size = static_cast<_inplace_size_t<N>>(n);
+    }
+
+    _inplace_storage() noexcept {}
+
+    _inplace_storage(const _inplace_storage &other) {
+        ala::uninitialized_copy(other._ptr(), other._ptr() + other._size,
+                                this->_ptr());
+        _size = other._size;
+    }
+
+    _inplace_storage(_inplace_storage &&other) noexcept(
+        is_nothrow_move_constructible<T>::value) {
+        ala::uninitialized_move(other._ptr(), other._ptr() + other._size,
+                                this->_ptr());
+        _size = other._size;
+    }
+
+    _inplace_storage &operator=(const _inplace_storage &other) {
+        if (this != ala::addressof(other))
+            this->_assign(other._ptr(), other._size);
+        return *this;
+    }
+
+    _inplace_storage &operator=(_inplace_storage &&other) noexcept(
+        is_nothrow_move_constructible<T>::value &&
+        is_nothrow_move_assignable<T>::value) {
+        if (this != ala::addressof(other))
+            this->_assign(ala::make_move_iterator(other._ptr()), other._size);
+        return *this;
+    }
+
+    ~_inplace_storage() {
+        ala::destroy(this->_ptr(), this->_ptr() + _size);
+    }
+};
+
+// vector of at most N elements that never allocates. Growing past N throws
+// bad_alloc, the try_ modifiers return nullptr instead and leave it as it
+// was, the unchecked_ ones require room.
+template<class T, size_t N>
+class inplace_vector: protected _inplace_storage<T, N> {
+public:
+    // types:
+    using value_type = T;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type *;
+    using const_pointer = const value_type *;
+    using iterator = ptr_iterator<value_type, pointer>;
+    using const_iterator = ptr_iterator<const value_type, const_pointer>;
+    using reverse_iterator = ala::reverse_iterator<iterator>;
+    using const_reverse_iterator = ala::reverse_iterator<const_iterator>;
+
+protected:
+    using _base_t = _inplace_storage<T, N>;
+    using _trivial_t = is_trivial<value_type>;
+    using _base_t::_size;
+
+    constexpr void check_room(size_type n) const {
+        if (n > N)
+            throw bad_alloc();
+    }
+
+    template<class... Args>
+    constexpr void construct(pointer p, Args &&...args) {
+        this->construct(_trivial_t{}, p, ala::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    constexpr void construct(true_type, pointer p, Args &&...args) {
+        *p = value_type(ala::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    void construct(false_type, pointer p, Args &&...args) {
+        ala::construct_at(p, ala::forward<Args>(args)...);
+    }
+
+    template<class... V>
+    constexpr void v_fill(pointer first, pointer last, V &&...v) {
+        static_assert(sizeof...(V) == 0 || sizeof...(V) == 1, "Internal error");
+        this->do_fill(_trivial_t{}, first, last, ala::forward<V>(v)...);
+    }
+
+    constexpr void do_fill(true_type, pointer first, pointer last) {
+        ala::fill(first, last, value_type());
+    }
+
+    constexpr void do_fill(true_type, pointer first, pointer last,
+                           const value_type &v) {
+        ala::fill(first, last, v);
+    }
+
+    void do_fill(false_type, pointer first, pointer last) {
+        ala::uninitialized_value_construct(first, last);
+    }
+
+    void do_fill(false_type, pointer first, pointer last, const value_type &v) {
+        ala::uninitialized_fill(first, last, v);
+    }
+
+    template<class InputIter>
+    constexpr void cp(InputIter first, InputIter last, pointer out) {
+        this->cp(_trivial_t{}, first, last, out);
+    }
+
+    template<class InputIter>
+    constexpr void cp(true_type, InputIter first, InputIter last,
+                      pointer out) {
+        ala::copy(first, last, out);
+    }
+
+    template<class InputIter>
+    void cp(false_type, InputIter first, InputIter last, pointer out) {
+        ala::uninitialized_copy(first, last, out);
+    }
+
+    constexpr void cut(pointer position) noexcept {
+        this->cut(_trivial_t{}, position);
+    }
+
+    constexpr void cut(true_type, pointer position) noexcept {
+        _size = static_cast<decltype(_size)>(position - this->_ptr());
+    }
+
+    void cut(false_type, pointer position) noexcept {
+        pointer e = end();
+        for (; position != e; ++position, (void)--_size)
+            ala::destroy_at(position);
+    }
+
+    template<class InputIter>
+    constexpr enable_if_t<
+        !is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value>
+    iter_ctor_helper(InputIter first, InputIter last) {
+        for (; first != last; ++first)
+            this->emplace_back(*first);
+    }
+
+    template<class ForwardIter>
+    constexpr enable_if_t<
+        is_base_of<forward_iterator_tag, _iter_tag_t<ForwardIter>>::value>
+    iter_ctor_helper(ForwardIter first, ForwardIter last) {
+        size_type n = ala::distance(first, last);
+        this->check_room(n);
+        this->cp(first, last, this->_ptr());
+        _size = static_cast<decltype(_size)>(n);
+    }
+
+    template<class... V>
+    constexpr void v_ctor_helper(size_type n, V &&...v) {
+        this->check_room(n);
+        this->v_fill(this->_ptr(), this->_ptr() + n, ala::forward<V>(v)...);
+        _size = static_cast<decltype(_size)>(n);
+    }
+
+public:
+    // construct/copy/destroy:
+    constexpr inplace_vector() noexcept {}
+
+    constexpr explicit inplace_vector(size_type n) {
+        this->v_ctor_helper(n);
+    }
+
+    constexpr inplace_vector(size_type n, const value_type &v) {
+        this->v_ctor_helper(n, v);
+    }
+
+    template<class InputIter,
+             typename = enable_if_t<
+                 is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value>>
+    constexpr inplace_vector(InputIter first, InputIter last) {
+        this->iter_ctor_helper(first, last);
+    }
+
+    constexpr inplace_vector(initializer_list<value_type> il)
+        : inplace_vector(il.begin(), il.end()) {}
+
+    constexpr inplace_vector &operator=(initializer_list<value_type> il) {
+        this->assign(il.begin(), il.end());
+        return *this;
+    }
+
+protected:
+    template<class InputIter>
+    constexpr void assign_norealloc(InputIter first, InputIter last) {
+        size_type i = 0;
+        pointer p = this->_ptr();
+        for (; first != last && i < size(); ++first, (void)++i)
+            p[i] = *first;
+        if (i < size())
+            this->cut(p + i);
+        if (first != last)
+            this->insert(cend(), first, last);
+    }
+
+public:
+    template<class InputIter>
+    constexpr enable_if_t<
+        is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value &&
+        is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value>
+    assign(InputIter first, InputIter last) {
+        this->check_room(ala::distance(first, last));
+        this->assign_norealloc(first, last);
+    }
+
+    template<class InputIter>
+    constexpr enable_if_t<
+        is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value &&
+        !is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value>
+    assign(InputIter first, InputIter last) {
+        this->assign_norealloc(first, last);
+    }
+
+    constexpr void assign(size_type n, const value_type &v) {
+        this->check_room(n);
+        size_type i = 0;
+        pointer p = this->_ptr();
+        for (; n > 0 && i != size(); --n, (void)++i)
+            p[i] = v;
+        if (i != size())
+            this->cut(p + i);
+        if (n > 0)
+            this->insert(end(), n, v);
+    }
+
+    constexpr void assign(initializer_list<value_type> il) {
+        this->assign(il.begin(), il.end());
+    }
+
+    constexpr void swap(inplace_vector &other) noexcept(
+        is_nothrow_move_constructible<value_type>::value &&
+        is_nothrow_swappable<value_type>::value) {
+        inplace_vector *a = this, *b = &other;
+        if (a->size() > b->size())
+            ala::swap(a, b);
+        pointer ad = a->_ptr(), bd = b->_ptr();
+        size_type k = a->size();
+        ala::swap_ranges(ad, ad + k, bd);
+        for (size_type i = k; i != b->size(); ++i)
+            a->construct(ad + i, ala::move(bd[i]));
+        a->_size = b->_size;
+        b->cut(bd + k);
+    }
+
+    // iterator:
+    constexpr iterator begin() noexcept {
+        return this->_ptr();
+    }
+
+    constexpr const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    constexpr iterator end() noexcept {
+        return this->_ptr() + size();
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return cend();
+    }
+
+    constexpr reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    constexpr const_reverse_iterator rbegin() const noexcept {
+        return crbegin();
+    }
+
+    constexpr reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    constexpr const_reverse_iterator rend() const noexcept {
+        return crend();
+    }
+
+    constexpr const_iterator cbegin() const noexcept {
+        return const_iterator(this->_ptr());
+    }
+
+    constexpr const_iterator cend() const noexcept {
+        return const_iterator(this->_ptr() + size());
+    }
+
+    constexpr const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(cend());
+    }
+
+    constexpr const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(cbegin());
+    }
+
+    // capacity:
+    constexpr size_type size() const noexcept {
+        return _size;
+    }
+
+    static constexpr size_type max_size() noexcept {
+        return N;
+    }
+
+    static constexpr size_type capacity() noexcept {
+        return N;
+    }
+
+    ALA_NODISCARD constexpr bool empty() const noexcept {
+        return _size == 0;
+    }
+
+protected:
+    template<class... V>
+    constexpr void v_resize(size_type n, V &&...v) {
+        if (size() >= n) {
+            this->cut(this->_ptr() + n);
+            return;
+        }
+        this->check_room(n);
+        this->v_fill(end(), this->_ptr() + n, ala::forward<V>(v)...);
+        _size = static_cast<decltype(_size)>(n);
+    }
+
+public:
+    constexpr void resize(size_type n) {
+        this->v_resize(n);
+    }
+
+    constexpr void resize(size_type n, const value_type &v) {
+        this->v_resize(n, v);
+    }
+
+    static constexpr void reserve(size_type n) {
+        if (n > N)
+            throw bad_alloc();
+    }
+
+    static constexpr void shrink_to_fit() noexcept {}
+
+    // element access:
+    constexpr reference operator[](size_type n) {
+        return this->_ptr()[n];
+    }
+
+    constexpr const_reference operator[](size_type n) const {
+        return this->_ptr()[n];
+    }
+
+    constexpr reference at(size_type n) {
+        if (!(n < size()))
+            throw out_of_range("ala::inplace_vector index out of range");
+        return this->_ptr()[n];
+    }
+
+    constexpr const_reference at(size_type n) const {
+        if (!(n < size()))
+            throw out_of_range("ala::inplace_vector index out of range");
+        return this->_ptr()[n];
+    }
+
+    constexpr reference front() {
+        return this->_ptr()[0];
+    }
+
+    constexpr const_reference front() const {
+        return this->_ptr()[0];
+    }
+
+    constexpr reference back() {
+        return this->_ptr()[_size - 1];
+    }
+
+    constexpr const_reference back() const {
+        return this->_ptr()[_size - 1];
+    }
+
+    // data access:
+    constexpr value_type *data() noexcept {
+        return this->_ptr();
+    }
+
+    constexpr const value_type *data() const noexcept {
+        return this->_ptr();
+    }
+
+    // modifiers:
+    template<class... Args>
+    constexpr reference emplace_back(Args &&...args) {
+        this->check_room(size() + 1);
+        return this->unchecked_emplace_back(ala::forward<Args>(args)...);
+    }
+
+    constexpr void push_back(const value_type &v) {
+        this->emplace_back(v);
+    }
+
+    constexpr void push_back(value_type &&v) {
+        this->emplace_back(ala::move(v));
+    }
+
+    template<class... Args>
+    constexpr pointer try_emplace_back(Args &&...args) {
+        if (ALA_UNEXPECT(size() == N))
+            return nullptr;
+        return ala::addressof(
+            this->unchecked_emplace_back(ala::forward<Args>(args)...));
+    }
+
+    constexpr pointer try_push_back(const value_type &v) {
+        return this->try_emplace_back(v);
+    }
+
+    constexpr pointer try_push_back(value_type &&v) {
+        return this->try_emplace_back(ala::move(v));
+    }
+
+    template<class... Args>
+    constexpr reference unchecked_emplace_back(Args &&...args) {
+        assert(size() < N);
+        pointer p = this->_ptr() + size();
+        this->construct(p, ala::forward<Args>(args)...);
+        ++_size;
+        return *p;
+    }
+
+    constexpr reference unchecked_push_back(const value_type &v) {
+        return this->unchecked_emplace_back(v);
+    }
+
+    constexpr reference unchecked_push_back(value_type &&v) {
+        return this->unchecked_emplace_back(ala::move(v));
+    }
+
+    constexpr void pop_back() {
+        this->cut(this->_ptr() + size() - 1);
+    }
+
+    template<class... Args>
+    constexpr iterator emplace(const_iterator position, Args &&...args) {
+        difference_type offset = position - cbegin();
+        this->emplace_back(ala::forward<Args>(args)...);
+        ala::rotate(begin() + offset, end() - 1, end());
+        return begin() + offset;
+    }
+
+    constexpr iterator insert(const_iterator position, const value_type &v) {
+        return this->emplace(position, v);
+    }
+
+    constexpr iterator insert(const_iterator position, value_type &&v) {
+        return this->emplace(position, ala::move(v));
+    }
+
+    constexpr iterator insert(const_iterator position, size_type n,
+                              const value_type &v) {
+        difference_type offset = position - cbegin();
+        this->check_room(size() + n);
+        this->v_fill(end(), end() + n, v);
+        _size += static_cast<decltype(_size)>(n);
+        ala::rotate(begin() + offset, end() - n, end());
+        return begin() + offset;
+    }
+
+    template<class InputIter>
+    constexpr enable_if_t<
+        is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value &&
+            is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value,
+        iterator>
+    insert(const_iterator position, InputIter first, InputIter last) {
+        size_type n = ala::distance(first, last);
+        difference_type offset = position - cbegin();
+        this->check_room(size() + n);
+        this->cp(first, last, this->_ptr() + size());
+        _size += static_cast<decltype(_size)>(n);
+        ala::rotate(begin() + offset, end() - n, end());
+        return begin() + offset;
+    }
+
+    template<class InputIter>
+    constexpr enable_if_t<
+        is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value &&
+            !is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value,
+        iterator>
+    insert(const_iterator position, InputIter first, InputIter last) {
+        difference_type offset = position - cbegin();
+        for (; first != last; ++first, (void)++position)
+            position = this->emplace(position, *first);
+        return begin() + offset;
+    }
+
+    constexpr iterator insert(const_iterator position,
+                              initializer_list<value_type> il) {
+        return this->insert(position, il.begin(), il.end());
+    }
+
+    constexpr iterator erase(const_iterator position) {
+        pointer pos = this->_ptr() + (position - cbegin());
+        if (pos == end())
+            return end();
+        ala::move(pos + 1, this->_ptr() + size(), pos);
+        pop_back();
+        return pos;
+    }
+
+    constexpr iterator erase(const_iterator first, const_iterator last) {
+        pointer left = this->_ptr() + (first - cbegin());
+        pointer rght = this->_ptr() + (last - cbegin());
+        if (first == last)
+            return left;
+        pointer e = ala::move(rght, this->_ptr() + size(), left);
+        this->cut(e);
+        return left;
+    }
+
+    constexpr void clear() noexcept {
+        this->cut(this->_ptr());
+    }
+};
+
+template<class T, size_t N>
+using static_vector = inplace_vector<T, N>;
+
+template<class T, size_t N>
+constexpr bool operator==(const inplace_vector<T, N> &lhs,
+                          const inplace_vector<T, N> &rhs) {
+    if (lhs.size() == rhs.size())
+        return ala::equal(lhs.begin(), lhs.end(), rhs.begin());
+    return false;
+}
+
+template<class T, size_t N>
+constexpr bool operator!=(const inplace_vector<T, N> &lhs,
+                          const inplace_vector<T, N> &rhs) {
+    return !(lhs == rhs);
+}
+
+template<class T, size_t N>
+constexpr bool operator<(const inplace_vector<T, N> &lhs,
+                         const inplace_vector<T, N> &rhs) {
+    return ala::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                        rhs.end());
+}
+
+template<class T, size_t N>
+constexpr bool operator>(const inplace_vector<T, N> &lhs,
+                         const inplace_vector<T, N> &rhs) {
+    return rhs < lhs;
+}
+
+template<class T, size_t N>
+constexpr bool operator<=(const inplace_vector<T, N> &lhs,
+                          const inplace_vector<T, N> &rhs) {
+    return !(rhs < lhs);
+}
+
+template<class T, size_t N>
+constexpr bool operator>=(const inplace_vector<T, N> &lhs,
+                          const inplace_vector<T, N> &rhs) {
+    return !(lhs < rhs);
+}
+
+template<class T, size_t N>
+constexpr void
+swap(inplace_vector<T, N> &lhs,
+     inplace_vector<T, N> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template<class T, size_t N, class U>
+constexpr typename inplace_vector<T, N>::size_type
+erase(inplace_vector<T, N> &c, const U &value) {
+    using iter_t = typename inplace_vector<T, N>::iterator;
+    using diff_t = typename inplace_vector<T, N>::difference_type;
+    iter_t i = ala::remove(c.begin(), c.end(), value);
+    diff_t n = ala::distance(i, c.end());
+    c.erase(i, c.end());
+    return n;
+}
+
+template<class T, size_t N, class Pred>
+constexpr typename inplace_vector<T, N>::size_type
+erase_if(inplace_vector<T, N> &c, Pred pred) {
+    using iter_t = typename inplace_vector<T, N>::iterator;
+    using diff_t = typename inplace_vector<T, N>::difference_type;
+    iter_t i = ala::remove_if(c.begin(), c.end(), pred);
+    diff_t n = ala::distance(i, c.end());
+    c.erase(i, c.end());
+    return n;
+}
+
+} // namespace ala
+
+#endif // HEAD
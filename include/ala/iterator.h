@@ -209,7 +209,9 @@ struct reverse_iterator {
         return ala::addressof(operator*());
     }
 
-    constexpr reference operator[](difference_type n) const;
+    constexpr reference operator[](difference_type n) const {
+        return current[-n - 1];
+    }
 
     constexpr reverse_iterator &operator++() {
         --current;
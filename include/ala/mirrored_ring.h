@@ -0,0 +1,457 @@
+#ifndef _ALA_MIRRORED_RING_H
+#define _ALA_MIRRORED_RING_H
+
+#include <ala/config.h>
+#include <ala/detail/algorithm_base.h>
+#include <ala/detail/allocator.h>
+#include <ala/detail/ptr_iterator.h>
+#include <ala/span.h>
+
+#ifdef _ALA_LINUX
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace ala {
+
+#ifdef _ALA_LINUX
+
+// A FIFO whose storage is mapped twice back to back, so the element after
+// the last slot is the first slot again. Every window of up to capacity()
+// elements is then one contiguous range, begin() to end() included, and
+// parsers read across the wrap with plain pointers. The mapping is a
+// memfd of whole pages, elements are trivially copyable and live in the
+// pages without an allocator. The ring API is followed for the operations
+// at the ends, there is no insert or erase in the middle.
+template<class T>
+class mirrored_ring {
+public:
+    // types:
+    using value_type = T;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type *;
+    using const_pointer = const value_type *;
+    using iterator = ptr_iterator<value_type, pointer>;
+    using const_iterator = ptr_iterator<const value_type, const_pointer>;
+    using reverse_iterator = ala::reverse_iterator<iterator>;
+    using const_reverse_iterator = ala::reverse_iterator<const_iterator>;
+    static_assert(is_trivially_copyable<value_type>::value,
+                  "mirrored_ring elements live in shared pages");
+    static_assert((sizeof(value_type) & (sizeof(value_type) - 1)) == 0,
+                  "element size must divide the page size");
+
+protected:
+    pointer _data = nullptr;
+    size_type _circ = 0;
+    size_type _head = 0;
+    size_type _size = 0;
+
+    // 2 * bytes of address space, both halves the same pages of a memfd
+    static pointer map_mirror(size_type bytes) {
+        int fd = ::memfd_create("ala::mirrored_ring", MFD_CLOEXEC);
+        if (fd < 0)
+            throw bad_alloc();
+        void *base = MAP_FAILED;
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+            base = ::mmap(nullptr, 2 * bytes, PROT_NONE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            ::close(fd);
+            throw bad_alloc();
+        }
+        char *p = static_cast<char *>(base);
+        int prot = PROT_READ | PROT_WRITE, flags = MAP_SHARED | MAP_FIXED;
+        bool ok = ::mmap(p, bytes, prot, flags, fd, 0) != MAP_FAILED &&
+                  ::mmap(p + bytes, bytes, prot, flags, fd, 0) != MAP_FAILED;
+        ::close(fd);
+        if (!ok) {
+            ::munmap(base, 2 * bytes);
+            throw bad_alloc();
+        }
+        return reinterpret_cast<pointer>(p);
+    }
+
+    // at least n elements in whole pages
+    static size_type round_capacity(size_type n) {
+        size_type page = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+        size_type bytes = (n * sizeof(value_type) + page - 1) / page * page;
+        return (bytes == 0 ? page : bytes) / sizeof(value_type);
+    }
+
+    void destroy() noexcept {
+        if (_data != nullptr)
+            ::munmap(_data, 2 * _circ * sizeof(value_type));
+        _data = nullptr;
+        _circ = _head = _size = 0;
+    }
+
+    // a new mapping of at least n elements holding the current ones
+    void realloc(size_type n) {
+        size_type circ = this->round_capacity(n);
+        pointer data = this->map_mirror(circ * sizeof(value_type));
+        if (_size != 0)
+            ala::copy_n(this->_front(), _size, data);
+        size_type sz = _size;
+        this->destroy();
+        _data = data;
+        _circ = circ;
+        _size = sz;
+    }
+
+    size_type expand() const noexcept {
+        return _circ * 2;
+    }
+
+    // room for n more elements, grows as push_back does
+    void room(size_type n) {
+        if (_size + n > _circ)
+            this->realloc(_size + n > expand() ? _size + n : expand());
+    }
+
+    pointer _front() const noexcept {
+        return _data + _head;
+    }
+
+    void possess(mirrored_ring &&other) noexcept {
+        _data = other._data;
+        _circ = other._circ;
+        _head = other._head;
+        _size = other._size;
+        other._data = nullptr;
+        other._circ = other._head = other._size = 0;
+    }
+
+public:
+    // construct/copy/destroy:
+    mirrored_ring() noexcept {}
+
+    explicit mirrored_ring(size_type n) {
+        this->resize(n);
+    }
+
+    mirrored_ring(size_type n, const value_type &v) {
+        this->resize(n, v);
+    }
+
+    mirrored_ring(const mirrored_ring &other) {
+        if (other._circ != 0) {
+            this->realloc(other._circ);
+            this->push_back_n(other._front(), other._size);
+        }
+    }
+
+    mirrored_ring(mirrored_ring &&other) noexcept {
+        this->possess(ala::move(other));
+    }
+
+    mirrored_ring(initializer_list<value_type> il) {
+        this->push_back_n(il.begin(), il.size());
+    }
+
+    ~mirrored_ring() {
+        destroy();
+    }
+
+    mirrored_ring &operator=(const mirrored_ring &other) {
+        if (this != ala::addressof(other)) {
+            clear();
+            this->push_back_n(other._front(), other._size);
+        }
+        return *this;
+    }
+
+    mirrored_ring &operator=(mirrored_ring &&other) noexcept {
+        if (this != ala::addressof(other)) {
+            destroy();
+            this->possess(ala::move(other));
+        }
+        return *this;
+    }
+
+    mirrored_ring &operator=(initializer_list<value_type> il) {
+        clear();
+        this->push_back_n(il.begin(), il.size());
+        return *this;
+    }
+
+    void swap(mirrored_ring &other) noexcept {
+        ala::swap(_data, other._data);
+        ala::swap(_circ, other._circ);
+        ala::swap(_head, other._head);
+        ala::swap(_size, other._size);
+    }
+
+    // iterator:
+    iterator begin() noexcept {
+        return iterator(this->_front());
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    iterator end() noexcept {
+        return iterator(this->_front() + _size);
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return crbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return crend();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_iterator(this->_front());
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator(this->_front() + _size);
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(cend());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(cbegin());
+    }
+
+    // capacity:
+    size_type size() const noexcept {
+        return _size;
+    }
+
+    size_type max_size() const noexcept {
+        return numeric_limits<difference_type>::max() / 2 / sizeof(value_type);
+    }
+
+    void resize(size_type n) {
+        this->resize(n, value_type());
+    }
+
+    void resize(size_type n, const value_type &v) {
+        if (n > _size) {
+            value_type x = v;
+            this->room(n - _size);
+            pointer p = this->_front();
+            ala::uninitialized_fill(p + _size, p + n, x);
+        }
+        _size = n;
+    }
+
+    size_type capacity() const noexcept {
+        return _circ;
+    }
+
+    ALA_NODISCARD bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    void reserve(size_type n) {
+        if (n > capacity())
+            this->realloc(n);
+    }
+
+    void shrink_to_fit() {
+        if (empty())
+            this->destroy();
+        else if (this->round_capacity(_size) < _circ)
+            this->realloc(_size);
+    }
+
+    // element access:
+    reference operator[](size_type n) {
+        return this->_front()[n];
+    }
+
+    const_reference operator[](size_type n) const {
+        return this->_front()[n];
+    }
+
+    reference at(size_type n) {
+        if (!(n < size()))
+            throw out_of_range("ala::mirrored_ring index out of range");
+        return this->_front()[n];
+    }
+
+    const_reference at(size_type n) const {
+        if (!(n < size()))
+            throw out_of_range("ala::mirrored_ring index out of range");
+        return this->_front()[n];
+    }
+
+    reference front() {
+        return *this->_front();
+    }
+
+    const_reference front() const {
+        return *this->_front();
+    }
+
+    reference back() {
+        return this->_front()[_size - 1];
+    }
+
+    const_reference back() const {
+        return this->_front()[_size - 1];
+    }
+
+    // the elements, contiguous even when they wrap the storage
+    pointer data() noexcept {
+        return this->_front();
+    }
+
+    const_pointer data() const noexcept {
+        return this->_front();
+    }
+
+    // modifiers:
+    // x is built before room(), args may refer to elements that growth
+    // unmaps
+    template<class... Args>
+    reference emplace_back(Args &&...args) {
+        value_type x(ala::forward<Args>(args)...);
+        this->room(1);
+        pointer p = this->_front() + _size;
+        ::new (static_cast<void *>(p)) value_type(x);
+        ++_size;
+        return *p;
+    }
+
+    void push_back(const value_type &v) {
+        this->emplace_back(v);
+    }
+
+    void pop_back() {
+        --_size;
+    }
+
+    template<class... Args>
+    reference emplace_front(Args &&...args) {
+        value_type x(ala::forward<Args>(args)...);
+        this->room(1);
+        size_type head = _head == 0 ? _circ - 1 : _head - 1;
+        pointer p = _data + head;
+        ::new (static_cast<void *>(p)) value_type(x);
+        _head = head;
+        ++_size;
+        return *p;
+    }
+
+    void push_front(const value_type &v) {
+        this->emplace_front(v);
+    }
+
+    void pop_front() {
+        if (++_head == _circ)
+            _head = 0;
+        --_size;
+    }
+
+    // n elements from first at the end, one copy whatever the wrap. first
+    // must not point into the ring, growth would unmap it.
+    template<class ForwardIter>
+    void push_back_n(ForwardIter first, size_type n) {
+        this->room(n);
+        ala::uninitialized_copy_n(first, n, this->_front() + _size);
+        _size += n;
+    }
+
+    void append(span<const value_type> s) {
+        this->push_back_n(s.data(), s.size());
+    }
+
+    void pop_front_n(size_type n) noexcept {
+        _head += n;
+        if (_head >= _circ)
+            _head -= _circ;
+        _size -= n;
+    }
+
+    // copies the first n elements to out, then drops them
+    template<class OutputIter>
+    OutputIter pop_front_n(OutputIter out, size_type n) {
+        if (n != 0)
+            out = ala::copy_n(this->_front(), n, out);
+        this->pop_front_n(n);
+        return out;
+    }
+
+    // n slots after end(), one contiguous span for a producer to fill in
+    // place before commit()
+    span<value_type> prepare(size_type n) {
+        this->room(n);
+        return span<value_type>(this->_front() + _size, n);
+    }
+
+    // the first n slots of the last prepare() become elements at the end
+    void commit(size_type n) noexcept {
+        assert(n <= capacity() - size());
+        _size += n;
+    }
+
+    void clear() noexcept {
+        _head = _size = 0;
+    }
+};
+
+template<class T>
+bool operator==(const mirrored_ring<T> &lhs, const mirrored_ring<T> &rhs) {
+    if (lhs.size() == rhs.size())
+        return ala::equal(lhs.data(), lhs.data() + lhs.size(), rhs.data());
+    return false;
+}
+
+template<class T>
+bool operator!=(const mirrored_ring<T> &lhs, const mirrored_ring<T> &rhs) {
+    return !(lhs == rhs);
+}
+
+template<class T>
+bool operator<(const mirrored_ring<T> &lhs, const mirrored_ring<T> &rhs) {
+    return ala::lexicographical_compare(lhs.data(), lhs.data() + lhs.size(),
+                                        rhs.data(), rhs.data() + rhs.size());
+}
+
+template<class T>
+bool operator>(const mirrored_ring<T> &lhs, const mirrored_ring<T> &rhs) {
+    return rhs < lhs;
+}
+
+template<class T>
+bool operator<=(const mirrored_ring<T> &lhs, const mirrored_ring<T> &rhs) {
+    return !(rhs < lhs);
+}
+
+template<class T>
+bool operator>=(const mirrored_ring<T> &lhs, const mirrored_ring<T> &rhs) {
+    return !(lhs < rhs);
+}
+
+template<class T>
+void swap(mirrored_ring<T> &lhs, mirrored_ring<T> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+#endif // _ALA_LINUX
+
+} // namespace ala
+
+#endif // HEAD
@@ -0,0 +1,413 @@
+#ifndef _ALA_NUMERIC_H
+#define _ALA_NUMERIC_H
+
+#include <ala/detail/algorithm_base.h>
+#include <ala/detail/simd/numeric.h>
+#include <ala/execution.h>
+
+namespace ala {
+
+// Contiguous ranges of T, 4 or 8 bytes wide, summed by plus go to the
+// ala::intrin kernels
+template<class Iter, class T>
+struct _is_simd_numeric
+    : _and_<_is_simd_iter<Iter>, is_same<_simd_value_t<Iter>, T>,
+            bool_constant<sizeof(T) == 4 || sizeof(T) == 8>> {};
+
+template<class Op, class T>
+struct _is_simd_plus
+    : bool_constant<is_same<Op, plus<>>::value || is_same<Op, plus<T>>::value> {
+};
+
+template<class Op, class T>
+struct _is_simd_multiplies
+    : bool_constant<is_same<Op, multiplies<>>::value ||
+                    is_same<Op, multiplies<T>>::value> {};
+
+template<class ForwardIter, class T>
+constexpr void iota(ForwardIter first, ForwardIter last, T value) {
+    for (; first != last; ++first, (void)++value)
+        *first = value;
+}
+
+template<class InputIter, class T, class BinOp>
+constexpr T accumulate(InputIter first, InputIter last, T init, BinOp op) {
+    for (; first != last; ++first)
+        init = op(ala::move(init), *first);
+    return init;
+}
+
+template<class InputIter, class T>
+constexpr T _accumulate_dispatch(InputIter first, InputIter last, T init,
+                                 false_type) {
+    for (; first != last; ++first)
+        init = ala::move(init) + *first;
+    return init;
+}
+
+template<class InputIter, class T>
+constexpr T _accumulate_dispatch(InputIter first, InputIter last, T init,
+                                 true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_accumulate_dispatch(first, last, init, false_type{});
+#endif
+    return ala::intrin::simd_reduce(ala::to_address(first), last - first, init);
+}
+
+// accumulate is ordered, only integers may be summed out of order
+template<class InputIter, class T>
+constexpr T accumulate(InputIter first, InputIter last, T init) {
+    using tag_t = _and_<_is_simd_numeric<InputIter, T>, is_integral<T>>;
+    return ala::_accumulate_dispatch(first, last, init, tag_t{});
+}
+
+template<class InputIter, class T, class BinOp>
+constexpr T _reduce_dispatch(InputIter first, InputIter last, T init,
+                             BinOp op, false_type) {
+    for (; first != last; ++first)
+        init = op(ala::move(init), *first);
+    return init;
+}
+
+template<class InputIter, class T, class BinOp>
+constexpr T _reduce_dispatch(InputIter first, InputIter last, T init,
+                             BinOp op, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_reduce_dispatch(first, last, init, op, false_type{});
+#endif
+    return ala::intrin::simd_reduce(ala::to_address(first), last - first, init);
+}
+
+template<class InputIter, class T, class BinOp>
+constexpr T reduce(InputIter first, InputIter last, T init, BinOp op) {
+    using tag_t =
+        _and_<_is_simd_numeric<InputIter, T>, _is_simd_plus<BinOp, T>>;
+    return ala::_reduce_dispatch(first, last, init, op, tag_t{});
+}
+
+template<class InputIter, class T>
+constexpr T reduce(InputIter first, InputIter last, T init) {
+    return ala::reduce(first, last, init, plus<>());
+}
+
+template<class InputIter>
+constexpr typename iterator_traits<InputIter>::value_type
+reduce(InputIter first, InputIter last) {
+    using T = typename iterator_traits<InputIter>::value_type;
+    return ala::reduce(first, last, T(), plus<>());
+}
+
+template<class InputIter, class T, class BinOp, class UnaryOp>
+constexpr T transform_reduce(InputIter first, InputIter last, T init,
+                             BinOp reduce_op, UnaryOp transform_op) {
+    for (; first != last; ++first)
+        init = reduce_op(ala::move(init), transform_op(*first));
+    return init;
+}
+
+template<class InputIter1, class InputIter2, class T, class BinOp1,
+         class BinOp2>
+constexpr T _transform_reduce_dispatch(InputIter1 first1, InputIter1 last1,
+                                       InputIter2 first2, T init,
+                                       BinOp1 reduce_op, BinOp2 transform_op,
+                                       false_type) {
+    for (; first1 != last1; ++first1, (void)++first2)
+        init = reduce_op(ala::move(init), transform_op(*first1, *first2));
+    return init;
+}
+
+template<class InputIter1, class InputIter2, class T, class BinOp1,
+         class BinOp2>
+constexpr T _transform_reduce_dispatch(InputIter1 first1, InputIter1 last1,
+                                       InputIter2 first2, T init,
+                                       BinOp1 reduce_op, BinOp2 transform_op,
+                                       true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_transform_reduce_dispatch(first1, last1, first2, init,
+                                               reduce_op, transform_op,
+                                               false_type{});
+#endif
+    return ala::intrin::simd_dot(ala::to_address(first1),
+                                 ala::to_address(first2), last1 - first1, init);
+}
+
+// inner products of floating point ranges are vectorized
+template<class InputIter1, class InputIter2, class T, class BinOp1,
+         class BinOp2>
+constexpr T transform_reduce(InputIter1 first1, InputIter1 last1,
+                             InputIter2 first2, T init, BinOp1 reduce_op,
+                             BinOp2 transform_op) {
+    using tag_t = _and_<_is_simd_numeric<InputIter1, T>,
+                        _is_simd_numeric<InputIter2, T>, is_floating_point<T>,
+                        _is_simd_plus<BinOp1, T>,
+                        _is_simd_multiplies<BinOp2, T>>;
+    return ala::_transform_reduce_dispatch(first1, last1, first2, init,
+                                           reduce_op, transform_op, tag_t{});
+}
+
+template<class InputIter1, class InputIter2, class T>
+constexpr T transform_reduce(InputIter1 first1, InputIter1 last1,
+                             InputIter2 first2, T init) {
+    return ala::transform_reduce(first1, last1, first2, init, plus<>(),
+                                 multiplies<>());
+}
+
+template<class InputIter, class OutputIter, class T, class BinOp>
+constexpr OutputIter _scan_dispatch(InputIter first, InputIter last,
+                                    OutputIter out, T init, BinOp op,
+                                    bool inclusive, false_type) {
+    for (; first != last; ++first, (void)++out) {
+        T next = op(init, *first);
+        *out = inclusive ? next : ala::move(init);
+        init = ala::move(next);
+    }
+    return out;
+}
+
+template<class InputIter, class OutputIter, class T, class BinOp>
+constexpr OutputIter _scan_dispatch(InputIter first, InputIter last,
+                                    OutputIter out, T init, BinOp op,
+                                    bool inclusive, true_type) {
+#if _ALA_ENABLE_BUILTIN_IS_CONSTANT_EVALUATED
+    if (ala::is_constant_evaluated())
+        return ala::_scan_dispatch(first, last, out, init, op, inclusive,
+                                   false_type{});
+#endif
+    size_t n = last - first;
+    if (n == 0)
+        return out;
+    if (inclusive)
+        ala::intrin::simd_scan<true>(ala::to_address(first), n,
+                                     ala::to_address(out), init);
+    else
+        ala::intrin::simd_scan<false>(ala::to_address(first), n,
+                                      ala::to_address(out), init);
+    return out + n;
+}
+
+template<class InputIter, class OutputIter, class T, class BinOp>
+struct _is_simd_scan
+    : _and_<_is_simd_numeric<InputIter, T>, _is_simd_numeric<OutputIter, T>,
+            _is_simd_plus<BinOp, T>> {};
+
+template<class InputIter, class OutputIter, class BinOp, class T>
+constexpr OutputIter inclusive_scan(InputIter first, InputIter last,
+                                    OutputIter out, BinOp op, T init) {
+    using tag_t = _is_simd_scan<InputIter, OutputIter, T, BinOp>;
+    return ala::_scan_dispatch(first, last, out, init, op, true, tag_t{});
+}
+
+template<class InputIter, class OutputIter, class BinOp>
+constexpr OutputIter inclusive_scan(InputIter first, InputIter last,
+                                    OutputIter out, BinOp op) {
+    using T = typename iterator_traits<InputIter>::value_type;
+    if (first == last)
+        return out;
+    T init = *first;
+    *out = init;
+    return ala::inclusive_scan(++first, last, ++out, op, init);
+}
+
+template<class InputIter, class OutputIter>
+constexpr OutputIter inclusive_scan(InputIter first, InputIter last,
+                                    OutputIter out) {
+    return ala::inclusive_scan(first, last, out, plus<>());
+}
+
+template<class InputIter, class OutputIter, class T, class BinOp>
+constexpr OutputIter exclusive_scan(InputIter first, InputIter last,
+                                    OutputIter out, T init, BinOp op) {
+    using tag_t = _is_simd_scan<InputIter, OutputIter, T, BinOp>;
+    return ala::_scan_dispatch(first, last, out, init, op, false, tag_t{});
+}
+
+template<class InputIter, class OutputIter, class T>
+constexpr OutputIter exclusive_scan(InputIter first, InputIter last,
+                                    OutputIter out, T init) {
+    return ala::exclusive_scan(first, last, out, init, plus<>());
+}
+
+// Execution policy overloads, parallel ones need random access iterators
+// and split the range into a block per thread. Scans take two passes, block
+// sums first, then each block is scanned from the prefix of the sums.
+
+ALA_INLINE_CONSTEXPR_V size_t _parallel_grain = 1 << 15;
+
+template<class ExecPolicy, class Iter>
+struct _is_parallel_iter
+    : _and_<_is_parallel_policy<remove_cvref_t<ExecPolicy>>,
+            is_base_of<random_access_iterator_tag, _iter_tag_t<Iter>>> {};
+
+template<class ForwardIter, class T, class BinOp>
+T _parallel_reduce(ForwardIter first, ForwardIter last, T init, BinOp op,
+                   false_type) {
+    return ala::reduce(first, last, init, op);
+}
+
+template<class RandomIter, class T, class BinOp>
+T _parallel_reduce(RandomIter first, RandomIter last, T init, BinOp op,
+                   true_type) {
+    size_t n = last - first;
+    size_t k = ala::_parallel_block_count(n, _parallel_grain);
+    if (k < 2)
+        return ala::reduce(first, last, init, op);
+    vector<T> sums(k, init);
+    auto fn = [&](size_t i, size_t b, size_t e) {
+        sums[i] = ala::reduce(first + b + 1, first + e, T(first[b]), op);
+    };
+    ala::_parallel_blocks(n, k, fn);
+    for (size_t i = 0; i < k; ++i)
+        init = op(ala::move(init), sums[i]);
+    return init;
+}
+
+template<class ExecPolicy, class ForwardIter, class T, class BinOp>
+enable_if_t<is_execution_policy<remove_cvref_t<ExecPolicy>>::value, T>
+reduce(ExecPolicy &&, ForwardIter first, ForwardIter last, T init, BinOp op) {
+    using tag_t = _is_parallel_iter<ExecPolicy, ForwardIter>;
+    return ala::_parallel_reduce(first, last, init, op, tag_t{});
+}
+
+template<class ExecPolicy, class ForwardIter, class T>
+enable_if_t<is_execution_policy<remove_cvref_t<ExecPolicy>>::value, T>
+reduce(ExecPolicy &&policy, ForwardIter first, ForwardIter last, T init) {
+    return ala::reduce(ala::forward<ExecPolicy>(policy), first, last, init,
+                       plus<>());
+}
+
+template<class ExecPolicy, class ForwardIter>
+enable_if_t<is_execution_policy<remove_cvref_t<ExecPolicy>>::value,
+            typename iterator_traits<ForwardIter>::value_type>
+reduce(ExecPolicy &&policy, ForwardIter first, ForwardIter last) {
+    using T = typename iterator_traits<ForwardIter>::value_type;
+    return ala::reduce(ala::forward<ExecPolicy>(policy), first, last, T(),
+                       plus<>());
+}
+
+template<class ExecPolicy, class ForwardIter1, class ForwardIter2, class T,
+         class BinOp1, class BinOp2>
+enable_if_t<is_execution_policy<remove_cvref_t<ExecPolicy>>::value, T>
+transform_reduce(ExecPolicy &&, ForwardIter1 first1, ForwardIter1 last1,
+                 ForwardIter2 first2, T init, BinOp1 reduce_op,
+                 BinOp2 transform_op) {
+    size_t n = ala::distance(first1, last1);
+    size_t k = _is_parallel_iter<ExecPolicy, ForwardIter1>::value &&
+                       _is_parallel_iter<ExecPolicy, ForwardIter2>::value ?
+                   ala::_parallel_block_count(n, _parallel_grain) :
+                   1;
+    if (k < 2)
+        return ala::transform_reduce(first1, last1, first2, init, reduce_op,
+                                     transform_op);
+    vector<T> sums(k, init);
+    auto fn = [&](size_t i, size_t b, size_t e) {
+        sums[i] = ala::transform_reduce(
+            ala::next(first1, b + 1), ala::next(first1, e),
+            ala::next(first2, b + 1),
+            T(transform_op(*ala::next(first1, b), *ala::next(first2, b))),
+            reduce_op, transform_op);
+    };
+    ala::_parallel_blocks(n, k, fn);
+    for (size_t i = 0; i < k; ++i)
+        init = reduce_op(ala::move(init), sums[i]);
+    return init;
+}
+
+template<class ExecPolicy, class ForwardIter1, class ForwardIter2, class T>
+enable_if_t<is_execution_policy<remove_cvref_t<ExecPolicy>>::value, T>
+transform_reduce(ExecPolicy &&policy, ForwardIter1 first1, ForwardIter1 last1,
+                 ForwardIter2 first2, T init) {
+    return ala::transform_reduce(ala::forward<ExecPolicy>(policy), first1,
+                                 last1, first2, init, plus<>(), multiplies<>());
+}
+
+template<class ForwardIter, class OutputIter, class T, class BinOp>
+OutputIter _parallel_scan(ForwardIter first, ForwardIter last, OutputIter out,
+                          T init, BinOp op, bool inclusive, false_type) {
+    return inclusive ? ala::inclusive_scan(first, last, out, op, init) :
+                       ala::exclusive_scan(first, last, out, init, op);
+}
+
+template<class RandomIter, class OutputIter, class T, class BinOp>
+OutputIter _parallel_scan(RandomIter first, RandomIter last, OutputIter out,
+                          T init, BinOp op, bool inclusive, true_type) {
+    size_t n = last - first;
+    size_t k = ala::_parallel_block_count(n, _parallel_grain);
+    if (k < 2)
+        return inclusive ? ala::inclusive_scan(first, last, out, op, init) :
+                           ala::exclusive_scan(first, last, out, init, op);
+    vector<T> sums(k, init);
+    auto reduce_fn = [&](size_t i, size_t b, size_t e) {
+        sums[i] = ala::reduce(first + b + 1, first + e, T(first[b]), op);
+    };
+    ala::_parallel_blocks(n, k, reduce_fn);
+    // sums[i] becomes the carry into block i
+    for (size_t i = 0; i < k; ++i) {
+        T next = op(init, sums[i]);
+        sums[i] = ala::move(init);
+        init = ala::move(next);
+    }
+    auto scan_fn = [&](size_t i, size_t b, size_t e) {
+        if (inclusive)
+            ala::inclusive_scan(first + b, first + e, out + b, op, sums[i]);
+        else
+            ala::exclusive_scan(first + b, first + e, out + b, sums[i], op);
+    };
+    ala::_parallel_blocks(n, k, scan_fn);
+    return out + n;
+}
+
+template<class ExecPolicy, class ForwardIter, class OutputIter, class BinOp,
+         class T>
+enable_if_t<is_execution_policy<remove_cvref_t<ExecPolicy>>::value, OutputIter>
+inclusive_scan(ExecPolicy &&, ForwardIter first, ForwardIter last,
+               OutputIter out, BinOp op, T init) {
+    using tag_t = _and_<_is_parallel_iter<ExecPolicy, ForwardIter>,
+                        _is_parallel_iter<ExecPolicy, OutputIter>>;
+    return ala::_parallel_scan(first, last, out, init, op, true, tag_t{});
+}
+
+template<class ExecPolicy, class ForwardIter, class OutputIter, class BinOp>
+enable_if_t<is_execution_policy<remove_cvref_t<ExecPolicy>>::value, OutputIter>
+inclusive_scan(ExecPolicy &&policy, ForwardIter first, ForwardIter last,
+               OutputIter out, BinOp op) {
+    using T = typename iterator_traits<ForwardIter>::value_type;
+    if (first == last)
+        return out;
+    T init = *first;
+    *out = init;
+    return ala::inclusive_scan(ala::forward<ExecPolicy>(policy), ++first, last,
+                               ++out, op, init);
+}
+
+template<class ExecPolicy, class ForwardIter, class OutputIter>
+enable_if_t<is_execution_policy<remove_cvref_t<ExecPolicy>>::value, OutputIter>
+inclusive_scan(ExecPolicy &&policy, ForwardIter first, ForwardIter last,
+               OutputIter out) {
+    return ala::inclusive_scan(ala::forward<ExecPolicy>(policy), first, last,
+                               out, plus<>());
+}
+
+template<class ExecPolicy, class ForwardIter, class OutputIter, class T,
+         class BinOp>
+enable_if_t<is_execution_policy<remove_cvref_t<ExecPolicy>>::value, OutputIter>
+exclusive_scan(ExecPolicy &&, ForwardIter first, ForwardIter last,
+               OutputIter out, T init, BinOp op) {
+    using tag_t = _and_<_is_parallel_iter<ExecPolicy, ForwardIter>,
+                        _is_parallel_iter<ExecPolicy, OutputIter>>;
+    return ala::_parallel_scan(first, last, out, init, op, false, tag_t{});
+}
+
+template<class ExecPolicy, class ForwardIter, class OutputIter, class T>
+enable_if_t<is_execution_policy<remove_cvref_t<ExecPolicy>>::value, OutputIter>
+exclusive_scan(ExecPolicy &&policy, ForwardIter first, ForwardIter last,
+               OutputIter out, T init) {
+    return ala::exclusive_scan(ala::forward<ExecPolicy>(policy), first, last,
+                               out, init, plus<>());
+}
+
+} // namespace ala
+
+#endif // HEAD
@@ -4,12 +4,30 @@
 #include <ala/config.h>
 
 #include <ala/detail/intrin/bit.h>
+#include <ala/detail/intrin/cpu_features.h>
 
 #include <ala/detail/intrin/rdrand.h>
 #include <ala/detail/intrin/rdseed.h>
+#include <ala/detail/simd/random.h>
 #include <ala/type_traits.h>
+#include <ala/span.h>
+#include <ala/vector.h>
 
 #include <limits>
+#include <cerrno>
+
+#if defined(_ALA_LINUX) || defined(_ALA_APPLE)
+    #include <sys/random.h>
+#elif defined(_ALA_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <Windows.h>
+    #include <bcrypt.h>
+    #if defined(_ALA_MSVC)
+        #pragma comment(lib, "bcrypt")
+    #endif
+#endif
 
 namespace ala {
 
@@ -19,6 +37,74 @@ struct bad_random_device: exception {
     explicit bad_random_device() {}
 };
 
+#ifdef _ALA_X86
+// One rdseed or rdrand word in at most tries attempts. A failed instruction
+// is retried after 1, 2, 4, ... pauses, rdseed fails while its source is
+// drained and rdrand, in rare cases, while it reseeds.
+template<bool RdSeed, class Word>
+bool _hw_entropy(Word *p, int tries = 10) {
+    for (int k = 0; k != tries; ++k) {
+        if (RdSeed ? ala::intrin::rdseed(p) : ala::intrin::rdrand(p))
+            return true;
+        for (int i = 0; i != 1 << k; ++i) {
+    #if defined(_ALA_MSVC)
+            _mm_pause();
+    #else
+            __builtin_ia32_pause();
+    #endif
+        }
+    }
+    return false;
+}
+#endif
+
+#if defined(_ALA_LINUX) || defined(_ALA_APPLE) || defined(_ALA_WIN32)
+constexpr bool _has_os_entropy = true;
+#else
+constexpr bool _has_os_entropy = false;
+#endif
+
+// n bytes of the os generator, false without one or when it fails
+inline bool _os_entropy(void *p, size_t n) {
+#if defined(_ALA_LINUX)
+    char *q = static_cast<char *>(p);
+    while (n != 0) {
+        ssize_t r = ::getrandom(q, n, 0);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        q += r;
+        n -= static_cast<size_t>(r);
+    }
+    return true;
+#elif defined(_ALA_APPLE)
+    // at most 256 bytes a call
+    char *q = static_cast<char *>(p);
+    for (size_t k; n != 0; q += k, n -= k) {
+        k = n < 256 ? n : 256;
+        if (::getentropy(q, k) != 0)
+            return false;
+    }
+    return true;
+#elif defined(_ALA_WIN32)
+    // the system preferred generator, link bcrypt off msvc
+    unsigned char *q = static_cast<unsigned char *>(p);
+    for (ULONG k; n != 0; q += k, n -= k) {
+        k = n < 0x10000000 ? static_cast<ULONG>(n) : 0x10000000;
+        if (!BCRYPT_SUCCESS(::BCryptGenRandom(
+                nullptr, q, k, BCRYPT_USE_SYSTEM_PREFERRED_RNG)))
+            return false;
+    }
+    return true;
+#else
+    (void)p;
+    (void)n;
+    return false;
+#endif
+}
+
 template<class UInt, bool RdSeed = true>
 struct random_device_adaptor {
     static_assert(is_unsigned<UInt>::value,
@@ -43,28 +129,100 @@ struct random_device_adaptor {
         return numeric_limits<result_type>::max();
     }
 
+    // throws once the instruction fails all its retries
     result_type operator()() {
-        int r = this->rd(&s);
-        if (r)
-            return s;
+        _word_t w;
+        if (ala::_hw_entropy<RdSeed>(&w))
+            return s = static_cast<result_type>(w);
         throw bad_random_device{};
     }
 
 protected:
-    template<bool Dummy = RdSeed>
-    enable_if_t<Dummy, int> rd(UInt *p) {
-        return ala::intrin::rdseed(&s);
-    }
-
-    template<bool Dummy = RdSeed>
-    enable_if_t<!Dummy, int> rd(UInt *p) {
-        return ala::intrin::rdrand(&s);
-    }
+    // the instruction operand of the same width, uint_fast32_t may be wider
+    using _word_t = conditional_t<
+        sizeof(UInt) == 2, unsigned short,
+        conditional_t<sizeof(UInt) == 4, unsigned int, unsigned long long>>;
 };
 
 using random_device = random_device_adaptor<uint_fast32_t>;
 using random_device_64 = random_device_adaptor<uint_fast64_t>;
 
+// Hardware entropy handed out of a buffer, typically one per thread from
+// local(). A refill draws a batch of rdseed (RdSeed) or rdrand words, the
+// os generator supplies the words an instruction still fails after its
+// retries and serves alone where the instruction is missing. With an os
+// generator the instruction gets a single attempt a word, as a drained
+// rdseed is slower to wait for than the os. Only when both fail is
+// bad_random_device thrown. A word then costs a load rather than an
+// instruction of hundreds of cycles.
+template<bool RdSeed = true>
+class entropy_pool {
+public:
+    using result_type = uint64_t;
+
+    entropy_pool() {}
+    entropy_pool(const entropy_pool &) = delete;
+    entropy_pool &operator=(const entropy_pool &) = delete;
+
+    // the pool of the calling thread
+    static entropy_pool &local() {
+        thread_local entropy_pool pool;
+        return pool;
+    }
+
+    static constexpr result_type min() {
+        return numeric_limits<result_type>::min();
+    }
+
+    static constexpr result_type max() {
+        return numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        if (ALA_UNEXPECT(_pos == _words))
+            this->_refill();
+        return _buf[_pos++];
+    }
+
+    // n bytes, in whole words, a word is never handed out twice
+    void fill(void *p, size_t n) {
+        char *q = static_cast<char *>(p);
+        while (n != 0) {
+            if (_pos == _words)
+                this->_refill();
+            size_t k = (_words - _pos) * 8 < n ? (_words - _pos) * 8 : n;
+            ala::memcpy(q, _buf + _pos, k);
+            _pos += (k + 7) / 8;
+            q += k;
+            n -= k;
+        }
+    }
+
+    void generate(span<result_type> out) {
+        this->fill(out.data(), out.size_bytes());
+    }
+
+protected:
+    static constexpr size_t _words = 32;
+    uint64_t _buf[_words];
+    size_t _pos = _words;
+
+    ALA_NOINLINE void _refill() {
+        size_t i = 0;
+#ifdef _ALA_X86
+        const auto &f = ala::intrin::cpu_features();
+        const bool has = RdSeed ? f.rdseed : f.rdrand;
+        unsigned long long w;
+        constexpr int tries = _has_os_entropy ? 1 : 10;
+        for (; has && i != _words && ala::_hw_entropy<RdSeed>(&w, tries); ++i)
+            _buf[i] = w;
+#endif
+        if (i != _words && !ala::_os_entropy(_buf + i, (_words - i) * 8))
+            throw bad_random_device{};
+        _pos = 0;
+    }
+};
+
 // see http://xoshiro.di.unimi.it/
 /*
 A        state xor-lshift
@@ -86,6 +244,14 @@ struct xoshiro {
     static constexpr UInt A = sizeof(UInt) == 8 ? 17 : 9;
     static constexpr UInt B = sizeof(UInt) == 8 ? 45 : 11;
 
+    static constexpr result_type min() {
+        return numeric_limits<result_type>::min();
+    }
+
+    static constexpr result_type max() {
+        return numeric_limits<result_type>::max();
+    }
+
     constexpr result_type rotl(result_type x, result_type k) {
         return (x << k) | (x >> (sizeof(UInt) * 8 - k));
     }
@@ -122,7 +288,7 @@ struct xoshiro {
     constexpr enable_if_t<
         sizeof(UInt) == 4 && is_same<Dummy, ScramberStarStar>::value, result_type>
     scramber() {
-        return rotl(s[0] * 5, 7) * 9;
+        return rotl(s[1] * 5, 7) * 9;
     }
 
     template<typename Dummy = Scramber>
@@ -147,15 +313,23 @@ struct xoshiro {
         return scramber();
     }
 
+    // fills out, the state lives in registers meanwhile
+    constexpr void generate(span<result_type> out) {
+        xoshiro e = *this;
+        for (result_type &x: out)
+            x = e();
+        *this = e;
+    }
+
     constexpr void discard(unsigned long long k) {
         for (; k > 0; --k)
             next();
     }
 
-    constexpr void do_jump(UInt (&jmp)[4]) {
+    constexpr void do_jump(const UInt (&jmp)[4]) {
         result_type s0 = 0, s1 = 0, s2 = 0, s3 = 0;
-        for (int i = 0; i < sizeof(jmp) / sizeof(*jmp); ++i)
-            for (int b = 0; b < sizeof(result_type) * 8; ++b) {
+        for (size_t i = 0; i < 4; ++i)
+            for (size_t b = 0; b < sizeof(result_type) * 8; ++b) {
                 if (jmp[i] & (result_type(1) << b)) {
                     s0 ^= s[0];
                     s1 ^= s[1];
@@ -170,31 +344,28 @@ struct xoshiro {
         s[3] = s3;
     }
 
+    // jump polynomials of the reference implementation
     constexpr void _jump(true_type) {
-        constexpr uint_fast64_t table[4] = {0x180ec6d33cfd0abaU,
-                                            0xd5a61266f0c9392cU,
-                                            0xa9582618e03fc9aaU,
-                                            0x39abdc4529b1661cU};
+        constexpr UInt table[4] = {0x180ec6d33cfd0abaU, 0xd5a61266f0c9392cU,
+                                   0xa9582618e03fc9aaU, 0x39abdc4529b1661cU};
         do_jump(table);
     }
 
     constexpr void _long_jump(true_type) {
-        constexpr uint_fast64_t table[4] = {0x76e15d3efefdcbbfU,
-                                            0xc5004e441c522fb3U,
-                                            0x77710069854ee241U,
-                                            0x39109bb02acbe635U};
+        constexpr UInt table[4] = {0x76e15d3efefdcbbfU, 0xc5004e441c522fb3U,
+                                   0x77710069854ee241U, 0x39109bb02acbe635U};
         do_jump(table);
     }
 
     constexpr void _jump(false_type) {
-        constexpr uint_fast32_t table[4] = {0x8764000bU, 0xf542d2d3U,
-                                            0x6fa035c3U, 0x77f2db5bU};
+        constexpr UInt table[4] = {0x8764000bU, 0xf542d2d3U, 0x6fa035c3U,
+                                   0x77f2db5bU};
         do_jump(table);
     }
 
     constexpr void _long_jump(false_type) {
-        constexpr uint_fast32_t table[4] = {0xb523952eU, 0x0b6f099fU,
-                                            0xccf5a0efU, 0x1c580662U};
+        constexpr UInt table[4] = {0xb523952eU, 0x0b6f099fU, 0xccf5a0efU,
+                                   0x1c580662U};
         do_jump(table);
     }
 
@@ -209,6 +380,18 @@ struct xoshiro {
     constexpr void long_jump() {
         return _long_jump(bool_constant<sizeof(UInt) == 8>{});
     }
+
+    // n engines a jump() apart, starting at this one, which then moves
+    // past them. Splitting a fixed seed gives every worker a reproducible
+    // stream that no other one reaches.
+    template<class OutputIter>
+    constexpr OutputIter split(size_t n, OutputIter out) {
+        for (; n > 0; --n, (void)++out) {
+            *out = *this;
+            jump();
+        }
+        return out;
+    }
 };
 
 template<typename UInt, UInt A, UInt B, UInt C>
@@ -216,6 +399,15 @@ struct xorshift {
     using result_type = UInt;
     result_type s;
 
+    // the state never becomes 0
+    static constexpr result_type min() {
+        return 1;
+    }
+
+    static constexpr result_type max() {
+        return numeric_limits<result_type>::max();
+    }
+
     constexpr void next() {
         s ^= s << A;
         s ^= s >> B;
@@ -230,6 +422,13 @@ struct xorshift {
         next();
         return s;
     }
+
+    constexpr void generate(span<result_type> out) {
+        xorshift e = *this;
+        for (result_type &x: out)
+            x = e();
+        *this = e;
+    }
 };
 
 template<typename UInt, UInt A, UInt C, UInt M>
@@ -237,6 +436,14 @@ struct linear_congruential_engine {
     using result_type = UInt;
     result_type s;
 
+    static constexpr result_type min() {
+        return C == 0 ? 1 : 0;
+    }
+
+    static constexpr result_type max() {
+        return M - 1;
+    }
+
     constexpr void next() {
         s = (s * A + C) % M;
     }
@@ -250,20 +457,392 @@ struct linear_congruential_engine {
         next();
         return s;
     }
+
+    constexpr void generate(span<result_type> out) {
+        linear_congruential_engine e = *this;
+        for (result_type &x: out)
+            x = e();
+        *this = e;
+    }
 };
 
 using xoshiro256pp = xoshiro<uint_fast64_t, ScramberPlusPlus>;
 using xoshiro256ss = xoshiro<uint_fast64_t, ScramberStarStar>;
 using xoshiro256p = xoshiro<uint_fast64_t, ScramberPlus>;
-using xoshiro128pp = xoshiro<uint_fast32_t, ScramberPlusPlus>;
-using xoshiro128ss = xoshiro<uint_fast32_t, ScramberStarStar>;
-using xoshiro128p = xoshiro<uint_fast32_t, ScramberPlus>;
+using xoshiro128pp = xoshiro<uint32_t, ScramberPlusPlus>;
+using xoshiro128ss = xoshiro<uint32_t, ScramberStarStar>;
+using xoshiro128p = xoshiro<uint32_t, ScramberPlus>;
+
+// Lanes interleaved xoshiro256 streams stepped together in vector
+// registers. Lane i starts i jump()s after the seed engine, 2^128 steps
+// apart, so the streams never overlap. A step yields one output of every
+// lane in lane order, operator() hands them out one at a time and the bulk
+// functions continue the same sequence.
+template<class Scramber, size_t Lanes = 8>
+struct xoshiro256_lanes {
+    static_assert(Lanes == 4 || Lanes == 8,
+                  "xoshiro256_lanes only support 4|8 lanes");
+    using result_type = uint64_t;
+    using engine_type = xoshiro<uint64_t, Scramber>;
+
+    explicit xoshiro256_lanes(engine_type e) {
+        for (size_t i = 0; i != Lanes; ++i, e.jump())
+            for (size_t j = 0; j != 4; ++j)
+                _s[j * Lanes + i] = e.s[j];
+    }
+
+    static constexpr result_type min() {
+        return numeric_limits<result_type>::min();
+    }
+
+    static constexpr result_type max() {
+        return numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        if (_pos == Lanes) {
+            this->_step<0>(_block, 1);
+            _pos = 0;
+        }
+        return _block[_pos++];
+    }
+
+    void discard(unsigned long long k) {
+        for (; k > 0; --k)
+            (*this)();
+    }
+
+    void generate(span<result_type> out) {
+        this->_generate<0>(out.data(), out.size());
+    }
+
+    // doubles in [0, 1) of the high 52 bits of an output
+    void generate_real(span<double> out) {
+        this->_generate<1>(out.data(), out.size());
+    }
+
+    // floats in [0, 1), two of an output, of the high 23 bits of its halves
+    void generate_real(span<float> out) {
+        this->_generate<2>(out.data(), out.size());
+    }
+
+protected:
+    uint64_t _s[4 * Lanes];
+    uint64_t _block[Lanes];
+    size_t _pos = Lanes;
+
+    template<int Conv>
+    static uint64_t _convert(uint64_t x) {
+        constexpr uint64_t d1 = 0x3ff0000000000000U, f1 = 0x3f800000U;
+        if (Conv == 1) {
+            uint64_t b = (x >> 12) | d1;
+            double d;
+            ala::memcpy(&d, &b, 8);
+            d -= 1.0;
+            ala::memcpy(&b, &d, 8);
+            return b;
+        }
+        if (Conv == 2) {
+            uint32_t b[2] = {static_cast<uint32_t>((x & 0xffffffffU) >> 9 | f1),
+                             static_cast<uint32_t>(x >> 41 | f1)};
+            float f[2];
+            ala::memcpy(f, b, 8);
+            f[0] -= 1.0f;
+            f[1] -= 1.0f;
+            ala::memcpy(&x, f, 8);
+        }
+        return x;
+    }
+
+    template<int Conv>
+    void _step(void *out, size_t n) {
+#if _ALA_SIMD_X86
+        ala::intrin::simd_xoshiro_fill<Scramber, Lanes, Conv>(_s, out, n);
+#else
+        engine_type e[Lanes];
+        for (size_t i = 0; i != Lanes; ++i)
+            for (size_t j = 0; j != 4; ++j)
+                e[i].s[j] = _s[j * Lanes + i];
+        char *p = static_cast<char *>(out);
+        for (size_t k = 0; k != n; ++k, p += Lanes * 8)
+            for (size_t i = 0; i != Lanes; ++i) {
+                uint64_t x = _convert<Conv>(e[i]());
+                ala::memcpy(p + i * 8, &x, 8);
+            }
+        for (size_t i = 0; i != Lanes; ++i)
+            for (size_t j = 0; j != 4; ++j)
+                _s[j * Lanes + i] = e[i].s[j];
+#endif
+    }
+
+    // Conv as in intrin::xoshiro_fill, an output fills 8 bytes of out
+    template<int Conv, class T>
+    void _generate(T *out, size_t n) {
+        constexpr size_t per = 8 / sizeof(T);
+        uint64_t x;
+        for (; n >= per && _pos != Lanes; n -= per, out += per) {
+            x = _convert<Conv>(_block[_pos++]);
+            ala::memcpy(out, &x, 8);
+        }
+        size_t steps = n / (per * Lanes);
+        this->_step<Conv>(out, steps);
+        out += steps * per * Lanes;
+        n -= steps * per * Lanes;
+        for (; n >= per; n -= per, out += per) {
+            x = _convert<Conv>((*this)());
+            ala::memcpy(out, &x, 8);
+        }
+        if (n != 0) {
+            x = _convert<Conv>((*this)());
+            ala::memcpy(out, &x, n * sizeof(T));
+        }
+    }
+};
+
+using xoshiro256pp_x4 = xoshiro256_lanes<ScramberPlusPlus, 4>;
+using xoshiro256pp_x8 = xoshiro256_lanes<ScramberPlusPlus, 8>;
+using xoshiro256ss_x4 = xoshiro256_lanes<ScramberStarStar, 4>;
+using xoshiro256ss_x8 = xoshiro256_lanes<ScramberStarStar, 8>;
+using xoshiro256p_x4 = xoshiro256_lanes<ScramberPlus, 4>;
+using xoshiro256p_x8 = xoshiro256_lanes<ScramberPlus, 8>;
 
 using xorshift32 = xorshift<uint_fast32_t, 13, 17, 5>;
 using xorshift64 = xorshift<uint_fast64_t, 13, 7, 17>;
 
 using minstd_rand = linear_congruential_engine<uint_fast32_t, 48271, 0, 2147483647>;
 
+// Counter based engine of Salmon et al., "Parallel random numbers: as easy
+// as 1, 2, 3". Block i of N outputs is R rounds of a keyed bijection of
+// the counter i, so discard(k) costs O(1) and any position of the stream
+// is reached by set_counter. Consts are the multiplier and the round key
+// increment of each pair of words. Tasks that seed the same engine and set
+// their id as the high counter word, e.set_counter({id, 0, 0, 0}), draw
+// disjoint streams whatever the thread that runs them.
+template<class UInt, size_t W, size_t N, size_t R, UInt... Consts>
+struct philox_engine {
+    static_assert(is_unsigned<UInt>::value,
+                  "philox_engine only support unsigned integral");
+    static_assert(W == 32 || W == 64,
+                  "philox_engine only support 32bit|64bit words");
+    static_assert(sizeof(UInt) * 8 >= W, "The size of uint too small");
+    static_assert(N == 2 || N == 4, "philox_engine only support 2|4 words");
+    static_assert(sizeof...(Consts) == N, "philox_engine needs N constants");
+    using result_type = UInt;
+    static constexpr size_t word_size = W;
+    static constexpr size_t word_count = N;
+    static constexpr size_t round_count = R;
+    static constexpr result_type default_seed = 20111115U;
+
+    explicit philox_engine(result_type value = default_seed) {
+        this->seed(value);
+    }
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return static_cast<_word_t>(-1);
+    }
+
+    // key word 0 to value, the others and the counter to 0
+    void seed(result_type value = default_seed) {
+        for (size_t i = 0; i != N / 2; ++i)
+            _k[i] = 0;
+        _k[0] = static_cast<_word_t>(value);
+        this->set_counter({});
+    }
+
+    // the counter, most significant word first, the next output is word 0
+    // of its block
+    void set_counter(const result_type (&c)[N]) {
+        for (size_t i = 0; i != N; ++i)
+            _x[N - 1 - i] = static_cast<_word_t>(c[i]);
+        _pos = N;
+    }
+
+    result_type operator()() {
+        if (_pos == N) {
+            this->_block(_x, _y);
+            this->_add(1);
+            _pos = 0;
+        }
+        return _y[_pos++];
+    }
+
+    void discard(unsigned long long k) {
+        if (k <= N - _pos) {
+            _pos += static_cast<size_t>(k);
+            return;
+        }
+        k -= N - _pos;
+        this->_add((k - 1) / N);
+        _pos = N;
+        (*this)();
+        _pos = static_cast<size_t>((k - 1) % N + 1);
+    }
+
+    // continues the sequence of operator(), whole blocks at once, in
+    // vector registers for Philox4x32 on x86
+    void generate(span<result_type> out) {
+        result_type *p = out.data();
+        size_t n = out.size();
+        for (; n != 0 && _pos != N; --n)
+            *p++ = _y[_pos++];
+        size_t blocks = n / N;
+        this->_fill(p, blocks,
+                    bool_constant<W == 32 && N == 4 && sizeof(UInt) == 4>{});
+        p += blocks * N;
+        for (n -= blocks * N; n != 0; --n)
+            *p++ = (*this)();
+    }
+
+    friend bool operator==(const philox_engine &lhs, const philox_engine &rhs) {
+        for (size_t i = 0; i != N; ++i)
+            if (lhs._x[i] != rhs._x[i] ||
+                (i < N / 2 && lhs._k[i] != rhs._k[i]))
+                return false;
+        if (lhs._pos != rhs._pos)
+            return false;
+        for (size_t i = lhs._pos; i != N; ++i)
+            if (lhs._y[i] != rhs._y[i])
+                return false;
+        return true;
+    }
+
+    friend bool operator!=(const philox_engine &lhs, const philox_engine &rhs) {
+        return !(lhs == rhs);
+    }
+
+protected:
+    using _word_t = conditional_t<W == 32, uint32_t, uint64_t>;
+
+    // the counter, low word first, of the block after _y
+    _word_t _x[N];
+    _word_t _k[N / 2];
+    _word_t _y[N];
+    size_t _pos;
+
+    static constexpr _word_t _const(size_t i) {
+        constexpr UInt c[] = {Consts...};
+        return static_cast<_word_t>(c[i]);
+    }
+
+    void _add(unsigned long long k) {
+        for (size_t i = 0; i != N && k != 0; ++i) {
+            _word_t w = static_cast<_word_t>(k);
+            k = W == 32 ? k >> (W % 64) : 0;
+            _x[i] += w;
+            k += _x[i] < w;
+        }
+    }
+
+    // Random123 word order, multiplier 0 takes word 2 and the result goes
+    // to words 0 and 1
+    void _block(const _word_t (&x)[N], _word_t (&y)[N]) const {
+        _word_t k[N / 2], hi0, hi1, lo0, lo1;
+        for (size_t i = 0; i != N; ++i)
+            y[i] = x[i];
+        for (size_t i = 0; i != N / 2; ++i)
+            k[i] = _k[i];
+        for (size_t r = 0; r != R; ++r) {
+            if (N == 2) {
+                lo0 = ala::intrin::umul(y[0], _const(0), &hi0);
+                y[0] = hi0 ^ y[1] ^ k[0];
+                y[1] = lo0;
+            } else {
+                lo0 = ala::intrin::umul(y[N / 2], _const(0), &hi0);
+                lo1 = ala::intrin::umul(y[0], _const(N / 2), &hi1);
+                y[0] = hi0 ^ y[1] ^ k[0];
+                y[1] = lo0;
+                y[N / 2] = hi1 ^ y[N - 1] ^ k[N / 4];
+                y[N - 1] = lo1;
+            }
+            for (size_t i = 0; i != N / 2; ++i)
+                k[i] += _const(2 * i + 1);
+        }
+    }
+
+    void _fill(result_type *p, size_t blocks, false_type) {
+        for (; blocks != 0; --blocks, p += N) {
+            this->_block(_x, _y);
+            this->_add(1);
+            for (size_t i = 0; i != N; ++i)
+                p[i] = _y[i];
+        }
+    }
+
+    // in runs that leave the carry out of the low word to _add
+    void _fill(result_type *p, size_t blocks, true_type) {
+#if _ALA_SIMD_X86
+        while (blocks != 0) {
+            uint64_t room = (uint64_t(1) << 32) - _x[0];
+            size_t run = room < blocks ? static_cast<size_t>(room) : blocks;
+            ala::intrin::simd_philox4x32_fill<R, _const(0), _const(1),
+                                              _const(2), _const(3)>(
+                _x, _k, reinterpret_cast<uint32_t *>(p), run);
+            this->_add(run);
+            p += run * N;
+            blocks -= run;
+        }
+#else
+        this->_fill(p, blocks, false_type{});
+#endif
+    }
+};
+
+using philox4x32 = philox_engine<uint32_t, 32, 4, 10, 0xCD9E8D57,
+                                 0x9E3779B9, 0xD2511F53, 0xBB67AE85>;
+using philox4x64 =
+    philox_engine<uint64_t, 64, 4, 10, 0xCA5A826395121157,
+                  0x9E3779B97F4A7C15, 0xD2E7470EE14C6C87, 0xBB67AE8584CAA73B>;
+
+// splitmix64, steps x and returns it spread over the 64 bits
+constexpr uint64_t _splitmix64(uint64_t &x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15U);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9U;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebU;
+    return z ^ (z >> 31);
+}
+
+template<class UInt>
+void _seed_word(UInt &w, uint64_t &mix) {
+    uint64_t x = ala::_splitmix64(mix);
+#if defined(_ALA_X86) || defined(_ALA_LINUX) || defined(_ALA_APPLE) || \
+    defined(_ALA_WIN32)
+    // without rdrand and an os generator the address mix is all there is
+    try {
+        x ^= entropy_pool<false>::local()();
+    } catch (const bad_random_device &) {
+    }
+#endif
+    // an all zero state is a fixed point, no word is 0
+    w = static_cast<UInt>(x | (x == 0));
+}
+
+template<class UInt, size_t N>
+void _seed_word(UInt (&s)[N], uint64_t &mix) {
+    for (size_t i = 0; i != N; ++i)
+        ala::_seed_word(s[i], mix);
+}
+
+// The engine of the calling thread, its state seeded on first use from
+// entropy_pool (rdrand or the os) where there is one, by a stack address of
+// the thread elsewhere. For xoshiro and xorshift. Workers that must be
+// reproducible take streams of split() of a fixed seed instead.
+template<class Engine = xoshiro256pp>
+Engine &thread_engine() {
+    thread_local Engine e = [] {
+        Engine r{};
+        // a stack address, r may be e itself
+        uint64_t mix = 0;
+        mix ^= reinterpret_cast<uintptr_t>(&mix);
+        ala::_seed_word(r.s, mix);
+        return r;
+    }();
+    return e;
+}
+
 // https://news.ycombinator.com/item?id=9352905
 // https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2018/p0952r0.html
 template<class URBG>
@@ -285,6 +864,101 @@ generate_real(URBG &g) {
     return *reinterpret_cast<Real *>(&s) - static_cast<Real>(1.0);
 }
 
+// width of an engine that yields every value of [0, 2^32) or [0, 2^64),
+// 0 for other ranges
+template<class URBG>
+struct _urbg_bits
+    : integral_constant<
+          int, URBG::min() != 0
+                   ? 0
+               : static_cast<uint64_t>(URBG::max()) == 0xffffffffU
+                   ? 32
+               : sizeof(typename URBG::result_type) >= 8 &&
+                       static_cast<uint64_t>(URBG::max()) ==
+                           numeric_limits<uint64_t>::max()
+                   ? 64
+                   : 0> {};
+
+constexpr int _floor_log2(uint64_t x) {
+    return x <= 1 ? 0 : 1 + ala::_floor_log2(x >> 1);
+}
+
+// Uniform 32 or 64 bit word, from the high bits of a wider engine or two
+// outputs of a narrower one. Engines of other ranges give the low k bits
+// of g() - min() for the largest k with 2^k <= max() - min() + 1, and
+// retry the values beyond.
+template<class URBG, class Word>
+Word _urbg_word(URBG &g, Word) {
+    using G = remove_cvref_t<URBG>;
+    constexpr int bits = _urbg_bits<G>::value;
+    constexpr int w = numeric_limits<Word>::digits;
+    if (bits >= w)
+        return static_cast<Word>(static_cast<uint64_t>(g()) >>
+                                 (bits >= w ? bits - w : 0));
+    if (bits != 0) {
+        uint64_t h = static_cast<uint32_t>(g());
+        return static_cast<Word>((h << 32) | static_cast<uint32_t>(g()));
+    }
+    constexpr uint64_t lo = static_cast<uint64_t>(G::min());
+    constexpr int k =
+        ala::_floor_log2(static_cast<uint64_t>(G::max()) - lo + 1);
+    uint64_t r = 0;
+    for (int have = 0; have < w; have += k) {
+        uint64_t x = static_cast<uint64_t>(g()) - lo;
+        while (x >> k)
+            x = static_cast<uint64_t>(g()) - lo;
+        r = (r << k) | x;
+    }
+    return static_cast<Word>(r);
+}
+
+// Uniform in [0, s) with s > 0 by Lemire's nearly divisionless method: the
+// high word of x * s for a random word x, rejecting the few low words that
+// would bias it. Only draws with a low word below s pay for the modulo.
+template<class Word, class URBG>
+Word _bounded_rand(URBG &g, Word s) {
+    Word hi, lo = ala::intrin::umul(ala::_urbg_word(g, Word()), s, &hi);
+    if (ALA_UNEXPECT(lo < s)) {
+        Word t = static_cast<Word>(0 - s) % s;
+        while (lo < t)
+            lo = ala::intrin::umul(ala::_urbg_word(g, Word()), s, &hi);
+    }
+    return hi;
+}
+
+// r1 uniform in [0, s1) and r2 in [0, s2) from one 64 bit word, for
+// s1 * s2 <= 2^64. The low word of x * s1 is a uniform fraction again and
+// is scaled by s2 in turn, the rejection bound is s1 * s2.
+template<class URBG>
+void _bounded_rand2(URBG &g, uint64_t s1, uint64_t s2, uint64_t &r1,
+                    uint64_t &r2) {
+    uint64_t x = ala::_urbg_word(g, uint64_t());
+    uint64_t lo = ala::intrin::umul(x, s1, &r1);
+    lo = ala::intrin::umul(lo, s2, &r2);
+    uint64_t s = s1 * s2;
+    if (ALA_UNEXPECT(lo < s)) {
+        uint64_t t = (0 - s) % s;
+        while (lo < t) {
+            x = ala::_urbg_word(g, uint64_t());
+            lo = ala::intrin::umul(x, s1, &r1);
+            lo = ala::intrin::umul(lo, s2, &r2);
+        }
+    }
+}
+
+// uniform in [0, l], from 32 bit words when they are enough
+template<class UInt, class URBG>
+UInt _uniform_int(URBG &g, UInt l) {
+    constexpr int bits = _urbg_bits<remove_cvref_t<URBG>>::value;
+    static_assert(sizeof(UInt) <= 8, "uniform_int only support 64bit");
+    uint64_t l64 = l;
+    if (bits != 64 && l64 < 0xffffffffU)
+        return ala::_bounded_rand(g, static_cast<uint32_t>(l64 + 1));
+    if (l64 == numeric_limits<uint64_t>::max())
+        return static_cast<UInt>(ala::_urbg_word(g, uint64_t()));
+    return static_cast<UInt>(ala::_bounded_rand(g, l64 + 1));
+}
+
 template<class Int = int>
 struct uniform_int_distribution {
     using result_type = Int;
@@ -334,17 +1008,22 @@ public:
 
     template<class URNG>
     result_type operator()(URNG &g, const param_type &p) {
-        result_type a = p.a();
-        result_type b = p.b();
-        result_type l = b - a;
-        if (l == 0)
-            return a;
-        int z = ala::intrin::clz(make_unsigned_t<Int>(l));
-        result_type mask = numeric_limits<result_type>::max() >> z;
-        result_type r = g() & mask;
-        for (; l < r;)
-            r = g() & mask;
-        return a + r;
+        using U = make_unsigned_t<result_type>;
+        U a = p.a(), l = U(p.b()) - a;
+        return static_cast<result_type>(U(a + ala::_uniform_int(g, l)));
+    }
+
+    template<class URNG>
+    void generate(span<result_type> out, URNG &g) {
+        this->generate(out, g, _p);
+    }
+
+    template<class URNG>
+    void generate(span<result_type> out, URNG &g, const param_type &p) {
+        using U = make_unsigned_t<result_type>;
+        U a = p.a(), l = U(p.b()) - a;
+        for (result_type &x: out)
+            x = static_cast<result_type>(U(a + ala::_uniform_int(g, l)));
     }
 
     // property functions
@@ -382,5 +1061,476 @@ public:
     }
 };
 
+// uniform in [0, 1) of the high 53 bits of a word
+template<class URBG>
+double _unit_double(URBG &g) {
+    return static_cast<double>(ala::_urbg_word(g, uint64_t()) >> 11) *
+           (1.0 / 9007199254740992.0);
+}
+
+// Ziggurat of Marsaglia and Tsang, "The Ziggurat Method for Generating
+// Random Variables". 256 layers of equal area v cover the density f, x
+// decreasing from x[1] = r, layer i >= 1 spans [0, x[i]) and lies under f
+// up to x[i + 1]. Layer 0 is the strip below f(r) with the tail beyond r,
+// x[0] = v / f(r).
+struct _ziggurat {
+    double x[257];
+    double f[257];
+};
+
+template<bool Normal>
+double _ziggurat_f(double x) {
+    return Normal ? ::std::exp(-0.5 * x * x) : ::std::exp(-x);
+}
+
+template<bool Normal>
+const _ziggurat &_ziggurat_table() {
+    static const _ziggurat z = [] {
+        _ziggurat t;
+        const double r = Normal ? 3.6541528853610088 : 7.6971174701310497;
+        const double fr = ala::_ziggurat_f<Normal>(r);
+        // r * f(r) and the area of the tail, sqrt(pi / 2) erfc(r / sqrt(2))
+        const double v =
+            Normal ? r * fr + 1.2533141373155003 *
+                                  ::std::erfc(r * 0.70710678118654752)
+                   : (r + 1) * fr;
+        t.x[0] = v / fr;
+        t.x[1] = r;
+        for (size_t i = 1; i != 256; ++i) {
+            double y = v / t.x[i] + ala::_ziggurat_f<Normal>(t.x[i]);
+            t.x[i + 1] = y >= 1 ? 0
+                         : Normal ? ::std::sqrt(-2 * ::std::log(y))
+                                  : -::std::log(y);
+        }
+        t.x[256] = 0;
+        for (size_t i = 0; i != 257; ++i)
+            t.f[i] = ala::_ziggurat_f<Normal>(t.x[i]);
+        return t;
+    }();
+    return z;
+}
+
+template<bool Normal, class URBG>
+double _ziggurat_sample(URBG &g, const _ziggurat &z);
+
+// the draws past x[i + 1]: the tail in layer 0, f decides in the others,
+// a rejected draw starts over
+template<bool Normal, class URBG>
+ALA_NOINLINE double _ziggurat_edge(URBG &g, const _ziggurat &z, size_t i,
+                                   double x, double sign) {
+    if (i == 0) {
+        const double r = z.x[1];
+        if (!Normal)
+            return r + ala::_ziggurat_sample<false>(g, z);
+        // Marsaglia's tail method
+        double a, b;
+        do {
+            a = -::std::log(1.0 - ala::_unit_double(g)) / r;
+            b = -::std::log(1.0 - ala::_unit_double(g));
+        } while (2 * b < a * a);
+        return sign * (r + a);
+    }
+    double y = z.f[i] + (z.f[i + 1] - z.f[i]) * ala::_unit_double(g);
+    if (y < ala::_ziggurat_f<Normal>(x))
+        return sign * x;
+    return ala::_ziggurat_sample<Normal>(g, z);
+}
+
+// A standard normal or exponential variate. One word picks the layer (8
+// bits), the sign (1 bit) and the abscissa (53 bits), which is accepted
+// outright unless it falls past x[i + 1], in about 1% of the draws. That
+// path stays small enough to inline, z is _ziggurat_table<Normal>().
+template<bool Normal, class URBG>
+double _ziggurat_sample(URBG &g, const _ziggurat &z) {
+    uint64_t w = ala::_urbg_word(g, uint64_t());
+    size_t i = w & 0xff;
+    double x =
+        static_cast<double>(w >> 11) * (1.0 / 9007199254740992.0) * z.x[i];
+    // branch free, the sign is a coin toss
+    double sign = Normal ? 1 - static_cast<int>((w >> 7) & 2) : 1;
+    if (ALA_EXPECT(x < z.x[i + 1]))
+        return sign * x;
+    return ala::_ziggurat_edge<Normal>(g, z, i, x, sign);
+}
+
+template<class Real = double>
+struct normal_distribution {
+    static_assert(is_floating_point<Real>::value,
+                  "normal_distribution only support floating point");
+    using result_type = Real;
+    struct param_type {
+        result_type _mean;
+        result_type _stddev;
+
+        using distribution_type = normal_distribution;
+
+        explicit param_type(result_type mean = 0, result_type stddev = 1)
+            : _mean(mean), _stddev(stddev) {}
+
+        result_type mean() const {
+            return _mean;
+        }
+        result_type stddev() const {
+            return _stddev;
+        }
+
+        friend bool operator==(const param_type &lhs, const param_type &rhs) {
+            return lhs._mean == rhs._mean && lhs._stddev == rhs._stddev;
+        }
+
+        friend bool operator!=(const param_type &lhs, const param_type &rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+protected:
+    param_type _p;
+
+public:
+    // constructors and reset functions
+    normal_distribution(): normal_distribution(0) {}
+    explicit normal_distribution(result_type mean, result_type stddev = 1)
+        : _p(mean, stddev) {}
+    explicit normal_distribution(const param_type &p): _p(p) {}
+    void reset() {}
+
+    // generating functions
+
+    template<class URNG>
+    result_type operator()(URNG &g) {
+        return (*this)(g, _p);
+    }
+
+    template<class URNG>
+    result_type operator()(URNG &g, const param_type &p) {
+        return static_cast<result_type>(
+            p.mean() +
+            p.stddev() *
+                ala::_ziggurat_sample<true>(g, ala::_ziggurat_table<true>()));
+    }
+
+    template<class URNG>
+    void generate(span<result_type> out, URNG &g) {
+        this->generate(out, g, _p);
+    }
+
+    template<class URNG>
+    void generate(span<result_type> out, URNG &g, const param_type &p) {
+        const _ziggurat &z = ala::_ziggurat_table<true>();
+        for (result_type &x: out)
+            x = static_cast<result_type>(
+                p.mean() + p.stddev() * ala::_ziggurat_sample<true>(g, z));
+    }
+
+    // property functions
+    result_type mean() const {
+        return _p.mean();
+    }
+    result_type stddev() const {
+        return _p.stddev();
+    }
+
+    param_type param() const {
+        return _p;
+    }
+
+    void param(const param_type &p) {
+        _p = p;
+    }
+
+    result_type min() const {
+        return numeric_limits<result_type>::lowest();
+    }
+
+    result_type max() const {
+        return numeric_limits<result_type>::max();
+    }
+
+    friend bool operator==(const normal_distribution &lhs,
+                           const normal_distribution &rhs) {
+        return lhs._p == rhs._p;
+    }
+
+    friend bool operator!=(const normal_distribution &lhs,
+                           const normal_distribution &rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+template<class Real = double>
+struct exponential_distribution {
+    static_assert(is_floating_point<Real>::value,
+                  "exponential_distribution only support floating point");
+    using result_type = Real;
+    struct param_type {
+        result_type _lambda;
+
+        using distribution_type = exponential_distribution;
+
+        explicit param_type(result_type lambda = 1): _lambda(lambda) {}
+
+        result_type lambda() const {
+            return _lambda;
+        }
+
+        friend bool operator==(const param_type &lhs, const param_type &rhs) {
+            return lhs._lambda == rhs._lambda;
+        }
+
+        friend bool operator!=(const param_type &lhs, const param_type &rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+protected:
+    param_type _p;
+
+public:
+    // constructors and reset functions
+    exponential_distribution(): exponential_distribution(1) {}
+    explicit exponential_distribution(result_type lambda): _p(lambda) {}
+    explicit exponential_distribution(const param_type &p): _p(p) {}
+    void reset() {}
+
+    // generating functions
+
+    template<class URNG>
+    result_type operator()(URNG &g) {
+        return (*this)(g, _p);
+    }
+
+    template<class URNG>
+    result_type operator()(URNG &g, const param_type &p) {
+        return static_cast<result_type>(
+            ala::_ziggurat_sample<false>(g, ala::_ziggurat_table<false>()) /
+            p.lambda());
+    }
+
+    template<class URNG>
+    void generate(span<result_type> out, URNG &g) {
+        this->generate(out, g, _p);
+    }
+
+    template<class URNG>
+    void generate(span<result_type> out, URNG &g, const param_type &p) {
+        const _ziggurat &z = ala::_ziggurat_table<false>();
+        const double scale = 1.0 / p.lambda();
+        for (result_type &x: out)
+            x = static_cast<result_type>(ala::_ziggurat_sample<false>(g, z) *
+                                         scale);
+    }
+
+    // property functions
+    result_type lambda() const {
+        return _p.lambda();
+    }
+
+    param_type param() const {
+        return _p;
+    }
+
+    void param(const param_type &p) {
+        _p = p;
+    }
+
+    result_type min() const {
+        return 0;
+    }
+
+    result_type max() const {
+        return numeric_limits<result_type>::max();
+    }
+
+    friend bool operator==(const exponential_distribution &lhs,
+                           const exponential_distribution &rhs) {
+        return lhs._p == rhs._p;
+    }
+
+    friend bool operator!=(const exponential_distribution &lhs,
+                           const exponential_distribution &rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+// Alias method, Vose's construction: column i of n holds i with
+// probability thr / 2^64 and alias otherwise. A draw is one word, its high
+// word of x * n picks the column and the low word, a fraction again, is
+// checked against thr, so it costs O(1) whatever the weights.
+template<class Int = int>
+struct discrete_distribution {
+    static_assert(is_integral<Int>::value,
+                  "discrete_distribution only support integral");
+    using result_type = Int;
+    struct param_type {
+        using distribution_type = discrete_distribution;
+
+        param_type(): _p(1, 1.0) {
+            this->_init();
+        }
+
+        template<class InputIter>
+        param_type(InputIter first, InputIter last): _p(first, last) {
+            this->_init();
+        }
+
+        param_type(initializer_list<double> il): _p(il) {
+            this->_init();
+        }
+
+        // weight fw(xmin + (i + 0.5) * (xmax - xmin) / count) for i
+        template<class UnaryOp>
+        param_type(size_t count, double xmin, double xmax, UnaryOp fw)
+            : _p(count != 0 ? count : 1) {
+            double d = (xmax - xmin) / _p.size();
+            for (size_t i = 0; i != _p.size(); ++i)
+                _p[i] = fw(xmin + (i + 0.5) * d);
+            this->_init();
+        }
+
+        vector<double> probabilities() const {
+            return _p;
+        }
+
+        friend bool operator==(const param_type &lhs, const param_type &rhs) {
+            return lhs._p == rhs._p;
+        }
+
+        friend bool operator!=(const param_type &lhs, const param_type &rhs) {
+            return !(lhs == rhs);
+        }
+
+    protected:
+        friend struct discrete_distribution;
+
+        struct _column {
+            uint64_t thr;
+            size_t alias;
+        };
+
+        vector<double> _p;
+        vector<_column> _table;
+
+        // an empty weight list is {1}
+        void _init() {
+            if (_p.empty())
+                _p.push_back(1.0);
+            size_t n = _p.size();
+            double sum = 0;
+            for (double w: _p)
+                sum += w;
+            vector<double> scaled(n);
+            vector<size_t> small, large;
+            for (size_t i = 0; i != n; ++i) {
+                _p[i] /= sum;
+                scaled[i] = _p[i] * n;
+                (scaled[i] < 1 ? small : large).push_back(i);
+            }
+            _table.resize(n);
+            while (!small.empty() && !large.empty()) {
+                size_t s = small.back(), l = large.back();
+                small.pop_back();
+                _table[s] = {_threshold(scaled[s]), l};
+                scaled[l] -= 1 - scaled[s];
+                if (scaled[l] < 1) {
+                    large.pop_back();
+                    small.push_back(l);
+                }
+            }
+            // columns left over by rounding are full
+            for (size_t i: large)
+                _table[i] = {numeric_limits<uint64_t>::max(), i};
+            for (size_t i: small)
+                _table[i] = {numeric_limits<uint64_t>::max(), i};
+        }
+
+        static uint64_t _threshold(double q) {
+            double t = q * 18446744073709551616.0;
+            return t < 18446744073709551616.0 ? static_cast<uint64_t>(t)
+                                              : numeric_limits<uint64_t>::max();
+        }
+
+        template<class URNG>
+        result_type _sample(URNG &g) const {
+            uint64_t i, lo = ala::intrin::umul(ala::_urbg_word(g, uint64_t()),
+                                               uint64_t(_table.size()), &i);
+            const _column &c = _table[i];
+            return static_cast<result_type>(lo < c.thr ? i : c.alias);
+        }
+    };
+
+protected:
+    param_type _p;
+
+public:
+    // constructors and reset functions
+    discrete_distribution() {}
+
+    template<class InputIter>
+    discrete_distribution(InputIter first, InputIter last): _p(first, last) {}
+
+    discrete_distribution(initializer_list<double> il): _p(il) {}
+
+    template<class UnaryOp>
+    discrete_distribution(size_t count, double xmin, double xmax, UnaryOp fw)
+        : _p(count, xmin, xmax, fw) {}
+
+    explicit discrete_distribution(const param_type &p): _p(p) {}
+    void reset() {}
+
+    // generating functions
+
+    template<class URNG>
+    result_type operator()(URNG &g) {
+        return _p._sample(g);
+    }
+
+    template<class URNG>
+    result_type operator()(URNG &g, const param_type &p) {
+        return p._sample(g);
+    }
+
+    template<class URNG>
+    void generate(span<result_type> out, URNG &g) {
+        this->generate(out, g, _p);
+    }
+
+    template<class URNG>
+    void generate(span<result_type> out, URNG &g, const param_type &p) {
+        for (result_type &x: out)
+            x = p._sample(g);
+    }
+
+    // property functions
+    vector<double> probabilities() const {
+        return _p.probabilities();
+    }
+
+    param_type param() const {
+        return _p;
+    }
+
+    void param(const param_type &p) {
+        _p = p;
+    }
+
+    result_type min() const {
+        return 0;
+    }
+
+    result_type max() const {
+        return static_cast<result_type>(_p._p.size() - 1);
+    }
+
+    friend bool operator==(const discrete_distribution &lhs,
+                           const discrete_distribution &rhs) {
+        return lhs._p == rhs._p;
+    }
+
+    friend bool operator!=(const discrete_distribution &lhs,
+                           const discrete_distribution &rhs) {
+        return !(lhs == rhs);
+    }
+};
+
 } // namespace ala
 #endif // HEAD
\ No newline at end of file
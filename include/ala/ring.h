@@ -3,7 +3,9 @@
 
 #include <ala/detail/algorithm_base.h>
 #include <ala/detail/allocator.h>
+#include <ala/detail/segmented_iterator.h>
 #include <ala/iterator.h>
+#include <ala/span.h>
 
 namespace ala {
 
@@ -146,6 +148,9 @@ protected:
     template<class, class>
     friend class ring;
 
+    template<class>
+    friend struct segmented_iterator_traits;
+
     constexpr ring_iterator(const Ring *ref, pointer ptr)
         : _ref(ref), _ptr(ptr) {}
 
@@ -153,6 +158,64 @@ protected:
     pointer _ptr = nullptr;
 };
 
+// Lap 0 of a ring is its storage from the head to the end, lap 1 is the
+// storage from the start, where the elements continue once they wrap
+template<class Ring>
+struct _ring_lap {
+    const Ring *_ref;
+    int _k;
+
+    _ring_lap &operator++() {
+        ++_k;
+        return *this;
+    }
+
+    bool operator==(const _ring_lap &rhs) const {
+        return _k == rhs._k;
+    }
+
+    bool operator!=(const _ring_lap &rhs) const {
+        return _k != rhs._k;
+    }
+};
+
+// A range of a ring is at most two pieces, so copy, find and the others
+// make no modulo per element
+template<class Value, class Ring>
+struct segmented_iterator_traits<ring_iterator<Value, Ring>> {
+    using is_segmented_iterator = true_type;
+    using _iter_t = ring_iterator<Value, Ring>;
+    using segment_iterator = _ring_lap<Ring>;
+    using local_iterator = Value *;
+
+    static segment_iterator segment(_iter_t i) {
+        const Ring *r = i._ref;
+        return segment_iterator{r, i._ptr < r->_data + r->_head ? 1 : 0};
+    }
+
+    static local_iterator local(_iter_t i) {
+        return ala::to_address(i._ptr);
+    }
+
+    static local_iterator begin(segment_iterator s) {
+        local_iterator p = ala::to_address(s._ref->_data);
+        return s._k == 0 ? p + s._ref->_head : p;
+    }
+
+    static local_iterator end(segment_iterator s) {
+        local_iterator p = ala::to_address(s._ref->_data);
+        return s._k == 0 ? p + s._ref->_circ : p + s._ref->_head;
+    }
+
+    static _iter_t compose(segment_iterator s, local_iterator l) {
+        const Ring *r = s._ref;
+        auto i = l - ala::to_address(r->_data);
+        if (static_cast<typename Ring::size_type>(i) == r->_circ)
+            i = 0;
+        return _iter_t(r, r->_data + i);
+    }
+};
+
 template<class T, class Alloc = allocator<T>>
 class ring {
 public:
@@ -170,6 +233,9 @@ public:
     using const_iterator = ring_iterator<const value_type, ring>;
     using reverse_iterator = ala::reverse_iterator<iterator>;
     using const_reverse_iterator = ala::reverse_iterator<const_iterator>;
+    using span_pair = pair<span<value_type>, span<value_type>>;
+    using const_span_pair =
+        pair<span<const value_type>, span<const value_type>>;
     static_assert(is_same<value_type, typename _alloc_traits::value_type>::value,
                   "allocator::value_type mismatch");
 
@@ -197,9 +263,48 @@ protected:
         return (idx + _circ + diff) % _circ;
     }
 
+    // number of elements stored contiguously from idx
+    size_type _contiguous(size_type idx) const {
+        size_type pos = (_head + idx) % _circ;
+        size_type n = size() - idx;
+        return _circ - pos < n ? _circ - pos : n;
+    }
+
+    // room for n more elements, grows as push_back does
+    void _room(size_type n) {
+        size_type new_size = size() + n;
+        if (new_size > capacity()) {
+            size_type new_capa = expand();
+            this->realloc(new_capa < new_size ? new_size : new_capa);
+        }
+    }
+
+    // the first n free slots after end(), at most two pieces, the second
+    // from the start of the storage
+    span_pair _free_spans(size_type n) const {
+        size_type k = _circ - _tail < n ? _circ - _tail : n;
+        value_type *p = ala::to_address(_data);
+        return span_pair(span<value_type>(p + _tail, k),
+                         span<value_type>(p, n - k));
+    }
+
     template<class, class>
     friend class ring_iterator;
 
+    template<class>
+    friend struct segmented_iterator_traits;
+
+    template<class T1, class Alloc1>
+    friend bool operator==(const ring<T1, Alloc1> &, const ring<T1, Alloc1> &);
+
+    template<class T1, class Alloc1>
+    friend bool _ring_less(const ring<T1, Alloc1> &, const ring<T1, Alloc1> &,
+                           true_type);
+
+    template<class T1, class Alloc1, class Pred>
+    friend constexpr typename ring<T1, Alloc1>::size_type
+    erase_if(ring<T1, Alloc1> &, Pred);
+
     void update(pointer m, size_type l, size_type h, size_type t) {
         assert(m != _data);
         _data = m;
@@ -208,9 +313,16 @@ protected:
         _tail = t;
     }
 
+    using _plain_t = _is_plain_construct<allocator_type>;
+
     template<class... V>
     pointer v_fill(pointer first, pointer last, V &&...v) {
         static_assert(sizeof...(V) == 0 || sizeof...(V) == 1, "Internal error");
+        return this->do_fill(first, last, _plain_t{}, ala::forward<V>(v)...);
+    }
+
+    template<class... V>
+    pointer do_fill(pointer first, pointer last, false_type, V &&...v) {
         pointer i = first;
         try {
             for (; i != last; ++i)
@@ -223,32 +335,65 @@ protected:
         return i;
     }
 
+    // the uninitialized algorithms store trivial values with memset
+    pointer do_fill(pointer first, pointer last, true_type) {
+        ala::uninitialized_value_construct(first, last);
+        return last;
+    }
+
+    template<class V>
+    pointer do_fill(pointer first, pointer last, true_type, V &&v) {
+        ala::uninitialized_fill(first, last, v);
+        return last;
+    }
+
     template<class InputIter>
     void mv(InputIter first, InputIter last, pointer out) {
-        InputIter i = first;
+        this->mv(first, last, out, _plain_t{});
+    }
+
+    template<class InputIter>
+    void mv(InputIter first, InputIter last, pointer out, false_type) {
+        pointer i = out;
         try {
-            for (; i != last; ++i, (void)++out)
-                _alloc_traits::construct(_alloc, out, ala::move(*i));
+            for (; first != last; ++first, (void)++i)
+                _alloc_traits::construct(_alloc, i, ala::move(*first));
         } catch (...) {
-            for (; i != first; ++first, (void)--out)
-                _alloc_traits::destroy(_alloc, out);
+            for (; i != out;)
+                _alloc_traits::destroy(_alloc, --i);
             throw;
         }
     }
 
+    // and copy trivially copyable ones with memmove
+    template<class InputIter>
+    void mv(InputIter first, InputIter last, pointer out, true_type) {
+        ala::uninitialized_move(first, last, out);
+    }
+
     template<class InputIter>
     void cp(InputIter first, InputIter last, pointer out) {
-        InputIter i = first;
+        this->cp(first, last, out, _plain_t{});
+    }
+
+    template<class InputIter>
+    void cp(InputIter first, InputIter last, pointer out, false_type) {
+        pointer i = out;
         try {
-            for (; i != last; ++i, (void)++out)
-                _alloc_traits::construct(_alloc, out, *i);
+            for (; first != last; ++first, (void)++i)
+                _alloc_traits::construct(_alloc, i, *first);
         } catch (...) {
-            for (; i != first; ++first, (void)--out)
-                _alloc_traits::destroy(_alloc, out);
+            for (; i != out;)
+                _alloc_traits::destroy(_alloc, --i);
             throw;
         }
     }
 
+    template<class InputIter>
+    void cp(InputIter first, InputIter last, pointer out, true_type) {
+        ala::uninitialized_copy(first, last, out);
+    }
+
     template<class... V>
     iterator v_fill(iterator first, iterator last, V &&...v) {
         static_assert(sizeof...(V) == 0 || sizeof...(V) == 1, "Internal error");
@@ -267,30 +412,74 @@ protected:
 
     template<class InputIter>
     void mv(InputIter first, InputIter last, iterator out) {
-        InputIter i = first;
+        iterator i = out;
         try {
-            for (; i != last; ++i, (void)++out)
-                _alloc_traits::construct(_alloc, out.operator->(), ala::move(*i));
+            for (; first != last; ++first, (void)++i)
+                _alloc_traits::construct(_alloc, i.operator->(),
+                                         ala::move(*first));
         } catch (...) {
-            for (; i != first; ++first, (void)--out)
-                _alloc_traits::destroy(_alloc, out.operator->());
+            for (; i != out;)
+                _alloc_traits::destroy(_alloc, (--i).operator->());
             throw;
         }
     }
 
     template<class InputIter>
     void cp(InputIter first, InputIter last, iterator out) {
-        InputIter i = first;
+        iterator i = out;
+        try {
+            for (; first != last; ++first, (void)++i)
+                _alloc_traits::construct(_alloc, i.operator->(), *first);
+        } catch (...) {
+            for (; i != out;)
+                _alloc_traits::destroy(_alloc, (--i).operator->());
+            throw;
+        }
+    }
+
+    // A range of a ring is at most two spans of its storage, each moved
+    // (Move) or copied to out with the pointer overloads above.
+    template<bool Move, class Value>
+    void _by_spans(ring_iterator<Value, ring> first,
+                   ring_iterator<Value, ring> last, pointer out) {
+        size_type n = last - first;
+        if (n == 0)
+            return;
+        const ring *r = first._ref;
+        size_type k = r->_data + r->_circ - first._ptr;
+        k = k < n ? k : n;
+        this->_span<Move>(first._ptr, first._ptr + k, out);
         try {
-            for (; i != last; ++i, (void)++out)
-                _alloc_traits::construct(_alloc, out.operator->(), *i);
+            this->_span<Move>(r->_data, r->_data + (n - k), out + k);
         } catch (...) {
-            for (; i != first; ++first, (void)--out)
-                _alloc_traits::destroy(_alloc, out.operator->());
+            for (pointer i = out + k; i != out;)
+                _alloc_traits::destroy(_alloc, --i);
             throw;
         }
     }
 
+    template<bool Move>
+    enable_if_t<Move> _span(pointer first, pointer last, pointer out) {
+        this->mv(first, last, out, _plain_t{});
+    }
+
+    template<bool Move>
+    enable_if_t<!Move> _span(pointer first, pointer last, pointer out) {
+        this->cp(first, last, out, _plain_t{});
+    }
+
+    template<class Value>
+    void mv(ring_iterator<Value, ring> first, ring_iterator<Value, ring> last,
+            pointer out) {
+        this->_by_spans<true>(first, last, out);
+    }
+
+    template<class Value>
+    void cp(ring_iterator<Value, ring> first, ring_iterator<Value, ring> last,
+            pointer out) {
+        this->_by_spans<false>(first, last, out);
+    }
+
     template<class InputIter, class Dummy = value_type>
     enable_if_t<(is_nothrow_move_constructible<Dummy>::value ||
                  !is_copy_constructible<Dummy>::value)>
@@ -521,7 +710,7 @@ protected:
 
 public:
     ring &operator=(const ring &other) {
-        if (this != addressof(other))
+        if (this != ala::addressof(other))
             copy_helper(other);
         return *this;
     }
@@ -529,7 +718,7 @@ public:
     ring &operator=(ring &&other) noexcept(
         _alloc_traits::propagate_on_container_move_assignment::value ||
         _alloc_traits::is_always_equal::value) {
-        if (this != addressof(other))
+        if (this != ala::addressof(other))
             move_helper(ala::move(other));
         return *this;
     }
@@ -543,7 +732,7 @@ public:
     swap(ring &other) noexcept(_alloc_traits::propagate_on_container_swap::value ||
                                _alloc_traits::is_always_equal::value) {
         this->swap_helper(other);
-        ala::_swap_adl(_data, other._data);
+        ala::swap(_data, other._data);
         ala::_swap_adl(_circ, other._circ);
         ala::_swap_adl(_head, other._head);
         ala::_swap_adl(_tail, other._tail);
@@ -762,6 +951,22 @@ public:
         return _data[this->_diff(_tail, -1)];
     }
 
+    // the elements as at most two contiguous pieces, the second empty
+    // unless the ring wraps, ready for writev or memcpy
+    span_pair data_spans() noexcept {
+        size_type k = this->_contiguous(0);
+        value_type *p = ala::to_address(_data);
+        return span_pair(span<value_type>(p + _head, k),
+                         span<value_type>(p, size() - k));
+    }
+
+    const_span_pair data_spans() const noexcept {
+        size_type k = this->_contiguous(0);
+        const value_type *p = ala::to_address(_data);
+        return const_span_pair(span<const value_type>(p + _head, k),
+                               span<const value_type>(p, size() - k));
+    }
+
     // modifiers:
     template<class... Args>
     reference emplace_back(Args &&...args) {
@@ -827,6 +1032,75 @@ public:
         _head = this->_diff(_head, 1);
     }
 
+    // n elements from first at the end, copied in at most two pieces, so
+    // trivially copyable ones take two memmoves. first must not point into
+    // the ring, growth would free it.
+    template<class ForwardIter>
+    void push_back_n(ForwardIter first, size_type n) {
+        this->_room(n);
+        pointer p = _data + _tail;
+        size_type k = _circ - _tail < n ? _circ - _tail : n;
+        ForwardIter mid = ala::next(first, k);
+        this->cp(first, mid, p);
+        try {
+            this->cp(mid, ala::next(mid, n - k), _data);
+        } catch (...) {
+            for (pointer i = p + k; i != p;)
+                _alloc_traits::destroy(_alloc, --i);
+            throw;
+        }
+        _tail = this->_diff(_tail, n);
+    }
+
+    void append(span<const value_type> s) {
+        this->push_back_n(s.data(), s.size());
+    }
+
+    // drops the first n elements, an emptied ring restarts at the front of
+    // its storage to leave the most contiguous room
+    void pop_front_n(size_type n) noexcept {
+        pointer p = _data + _head;
+        size_type k = this->_contiguous(0);
+        k = k < n ? k : n;
+        for (size_type i = 0; i != k; ++i)
+            _alloc_traits::destroy(_alloc, p + i);
+        for (size_type i = 0; i != n - k; ++i)
+            _alloc_traits::destroy(_alloc, _data + i);
+        _head = this->_diff(_head, n);
+        if (empty())
+            _head = _tail = 0;
+    }
+
+    // moves the first n elements to out in at most two pieces, then drops
+    // them
+    template<class OutputIter>
+    OutputIter pop_front_n(OutputIter out, size_type n) {
+        pointer p = _data + _head;
+        size_type k = this->_contiguous(0);
+        k = k < n ? k : n;
+        out = ala::move(p, p + k, out);
+        out = ala::move(_data, _data + (n - k), out);
+        this->pop_front_n(n);
+        return out;
+    }
+
+    // n slots of storage after end(), at most two pieces, for a producer
+    // to fill in place before commit(). The slots hold no objects, so the
+    // elements must be trivially copyable.
+    span_pair prepare(size_type n) {
+        static_assert(is_trivially_copyable<value_type>::value &&
+                          _plain_t::value,
+                      "prepare needs trivially copyable elements");
+        this->_room(n);
+        return this->_free_spans(n);
+    }
+
+    // the first n slots of the last prepare() become elements at the end
+    void commit(size_type n) noexcept {
+        assert(n <= capacity() - size());
+        _tail = this->_diff(_tail, n);
+    }
+
     template<class... Args>
     iterator emplace(const_iterator position, Args &&...args) {
         difference_type offset = position - cbegin();
@@ -960,11 +1234,21 @@ public:
     }
 };
 
+// Both rings are walked in contiguous pieces, at most three of them, so the
+// pointer overloads of equal and mismatch apply
 template<class T, class Alloc>
 bool operator==(const ring<T, Alloc> &lhs, const ring<T, Alloc> &rhs) {
-    if (lhs.size() == rhs.size())
-        return ala::equal(lhs.begin(), lhs.end(), rhs.begin());
-    return false;
+    using size_type = typename ring<T, Alloc>::size_type;
+    if (lhs.size() != rhs.size())
+        return false;
+    for (size_type i = 0, n = lhs.size(); i != n;) {
+        size_type l = ala::min(lhs._contiguous(i), rhs._contiguous(i));
+        const T *p = ala::to_address(lhs._idx2ptr(i));
+        if (!ala::equal(p, p + l, ala::to_address(rhs._idx2ptr(i))))
+            return false;
+        i += l;
+    }
+    return true;
 }
 
 template<class T, class Alloc>
@@ -973,11 +1257,37 @@ bool operator!=(const ring<T, Alloc> &lhs, const ring<T, Alloc> &rhs) {
 }
 
 template<class T, class Alloc>
-bool operator<(const ring<T, Alloc> &lhs, const ring<T, Alloc> &rhs) {
+bool _ring_less(const ring<T, Alloc> &lhs, const ring<T, Alloc> &rhs,
+                false_type) {
     return ala::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
                                         rhs.end());
 }
 
+template<class T, class Alloc>
+bool _ring_less(const ring<T, Alloc> &lhs, const ring<T, Alloc> &rhs,
+                true_type) {
+    using size_type = typename ring<T, Alloc>::size_type;
+    size_type n = ala::min(lhs.size(), rhs.size());
+    for (size_type i = 0; i != n;) {
+        size_type l = ala::min(ala::min(lhs._contiguous(i), rhs._contiguous(i)),
+                               n - i);
+        const T *p = ala::to_address(lhs._idx2ptr(i));
+        const T *q = ala::to_address(rhs._idx2ptr(i));
+        size_type k = ala::intrin::simd_mismatch<false>(p, q, l);
+        if (k != l)
+            return p[k] < q[k];
+        i += l;
+    }
+    return lhs.size() < rhs.size();
+}
+
+template<class T, class Alloc>
+bool operator<(const ring<T, Alloc> &lhs, const ring<T, Alloc> &rhs) {
+    // the first mismatch decides only when == and < agree
+    using tag_t = _and_<_is_simd_iter<const T *>, is_integral<T>>;
+    return ala::_ring_less(lhs, rhs, tag_t{});
+}
+
 template<class T, class Alloc>
 bool operator>(const ring<T, Alloc> &lhs, const ring<T, Alloc> &rhs) {
     return rhs < lhs;
@@ -1021,12 +1331,23 @@ constexpr typename ring<T, Alloc>::size_type erase(ring<T, Alloc> &c,
 template<class T, class Alloc, class Pred>
 constexpr typename ring<T, Alloc>::size_type erase_if(ring<T, Alloc> &c,
                                                       Pred pred) {
-    using iter_t = typename ring<T, Alloc>::iterator;
-    using diff_t = typename ring<T, Alloc>::difference_type;
-    iter_t i = ala::remove_if(c.begin(), c.end(), pred);
-    diff_t n = ala::distance(i, c.end());
-    c.erase(i, c.end());
-    return n;
+    using size_type = typename ring<T, Alloc>::size_type;
+    // compact the two contiguous pieces with pointers, then close the gap,
+    // both passes call the one pred
+    size_type n = c.size();
+    if (n == 0)
+        return 0;
+    size_type na = c._contiguous(0);
+    T *a = ala::to_address(c._idx2ptr(0));
+    size_type ka = ala::remove_if<T *, Pred &>(a, a + na, pred) - a;
+    size_type kb = 0;
+    if (na != n) {
+        T *b = ala::to_address(c._idx2ptr(na));
+        kb = ala::remove_if<T *, Pred &>(b, b + (n - na), pred) - b;
+        ala::move(c._idx2it(na), c._idx2it(na + kb), c._idx2it(ka));
+    }
+    c.erase(c._idx2it(ka + kb), c.end());
+    return n - ka - kb;
 }
 
 } // namespace ala
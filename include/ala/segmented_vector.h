@@ -0,0 +1,862 @@
+#ifndef _ALA_SEGMENTED_VECTOR_H
+#define _ALA_SEGMENTED_VECTOR_H
+
+#include <ala/vector.h>
+#include <ala/detail/segmented_iterator.h>
+
+namespace ala {
+
+// log2 of the elements in a chunk, chunks of about 16 KiB and at least 16
+// elements
+template<size_t N>
+struct _log2_floor: integral_constant<size_t, 1 + _log2_floor<N / 2>::value> {};
+
+template<>
+struct _log2_floor<1>: integral_constant<size_t, 0> {};
+
+template<class T>
+struct _segment_shift
+    : _log2_floor<(sizeof(T) >= 1024 ? 16 : 16384 / sizeof(T))> {};
+
+template<class Value, class SegVec>
+struct segmented_vector_iterator {
+#if ALA_API_VER >= 20
+    using iterator_concept = random_access_iterator_tag;
+#endif
+    using iterator_category = random_access_iterator_tag;
+    using value_type = Value;
+    using difference_type = typename SegVec::difference_type;
+    using size_type = typename SegVec::size_type;
+    using pointer = Value *;
+    using reference = Value &;
+
+    constexpr segmented_vector_iterator() {}
+
+    constexpr segmented_vector_iterator(const segmented_vector_iterator &other)
+        : _dir(other._dir), _idx(other._idx) {}
+
+    template<class Value1>
+    constexpr segmented_vector_iterator(
+        const segmented_vector_iterator<Value1, SegVec> &other)
+        : _dir(other._dir), _idx(other._idx) {}
+
+    constexpr segmented_vector_iterator &
+    operator=(const segmented_vector_iterator &other) = default;
+
+    constexpr pointer operator->() const {
+        return _dir[_idx >> SegVec::_shift] + (_idx & SegVec::_mask);
+    }
+
+    constexpr reference operator*() const {
+        return *(this->operator->());
+    }
+
+    template<class Value1>
+    constexpr bool
+    operator==(const segmented_vector_iterator<Value1, SegVec> &rhs) const {
+        return _idx == rhs._idx;
+    }
+
+    template<class Value1>
+    constexpr bool
+    operator!=(const segmented_vector_iterator<Value1, SegVec> &rhs) const {
+        return !(*this == rhs);
+    }
+
+    template<class Value1>
+    constexpr bool
+    operator<(const segmented_vector_iterator<Value1, SegVec> &rhs) const {
+        return _idx < rhs._idx;
+    }
+
+    template<class Value1>
+    constexpr bool
+    operator>(const segmented_vector_iterator<Value1, SegVec> &rhs) const {
+        return rhs < *this;
+    }
+
+    template<class Value1>
+    constexpr bool
+    operator<=(const segmented_vector_iterator<Value1, SegVec> &rhs) const {
+        return !(rhs < *this);
+    }
+
+    template<class Value1>
+    constexpr bool
+    operator>=(const segmented_vector_iterator<Value1, SegVec> &rhs) const {
+        return !(*this < rhs);
+    }
+
+    constexpr segmented_vector_iterator &operator++() {
+        ++_idx;
+        return *this;
+    }
+
+    constexpr segmented_vector_iterator operator++(int) {
+        segmented_vector_iterator tmp(*this);
+        ++*this;
+        return tmp;
+    }
+
+    constexpr segmented_vector_iterator &operator--() {
+        --_idx;
+        return *this;
+    }
+
+    constexpr segmented_vector_iterator operator--(int) {
+        segmented_vector_iterator tmp(*this);
+        --*this;
+        return tmp;
+    }
+
+    constexpr segmented_vector_iterator &operator+=(difference_type n) {
+        _idx += n;
+        return *this;
+    }
+
+    constexpr segmented_vector_iterator &operator-=(difference_type n) {
+        _idx -= n;
+        return *this;
+    }
+
+    constexpr segmented_vector_iterator operator+(difference_type n) const {
+        segmented_vector_iterator tmp(*this);
+        tmp += n;
+        return tmp;
+    }
+
+    constexpr segmented_vector_iterator operator-(difference_type n) const {
+        segmented_vector_iterator tmp(*this);
+        tmp -= n;
+        return tmp;
+    }
+
+    template<class Value1>
+    constexpr difference_type
+    operator-(const segmented_vector_iterator<Value1, SegVec> &rhs) const {
+        return (difference_type)_idx - (difference_type)rhs._idx;
+    }
+
+    friend constexpr segmented_vector_iterator
+    operator+(difference_type lhs, segmented_vector_iterator rhs) {
+        return rhs + lhs;
+    }
+
+    constexpr reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
+protected:
+    using _dir_t = const typename SegVec::pointer *;
+
+    template<class, class>
+    friend struct segmented_vector_iterator;
+
+    template<class>
+    friend struct segmented_iterator_traits;
+
+    template<class, class, size_t>
+    friend class segmented_vector;
+
+    template<class, class>
+    friend class deque;
+
+    constexpr segmented_vector_iterator(_dir_t dir, size_type idx)
+        : _dir(dir), _idx(idx) {}
+
+    _dir_t _dir = nullptr;
+    size_type _idx = 0;
+};
+
+// the k-th chunk of a directory
+template<class SegVec>
+struct _segment_cursor {
+    const typename SegVec::pointer *_dir;
+    typename SegVec::size_type _k;
+
+    _segment_cursor &operator++() {
+        ++_k;
+        return *this;
+    }
+
+    bool operator==(const _segment_cursor &rhs) const {
+        return _k == rhs._k;
+    }
+
+    bool operator!=(const _segment_cursor &rhs) const {
+        return _k != rhs._k;
+    }
+};
+
+// Chunks of SegVec::_mask + 1 elements, shared with deque whose positions
+// start at an offset into its block map
+template<class Value, class SegVec>
+struct segmented_iterator_traits<segmented_vector_iterator<Value, SegVec>> {
+    using is_segmented_iterator = true_type;
+    using _iter_t = segmented_vector_iterator<Value, SegVec>;
+    using segment_iterator = _segment_cursor<SegVec>;
+    using local_iterator = Value *;
+    using size_type = typename SegVec::size_type;
+
+    static segment_iterator segment(_iter_t i) {
+        return segment_iterator{i._dir, i._idx >> SegVec::_shift};
+    }
+
+    static local_iterator local(_iter_t i) {
+        return i._dir[i._idx >> SegVec::_shift] + (i._idx & SegVec::_mask);
+    }
+
+    static local_iterator begin(segment_iterator s) {
+        return s._dir[s._k];
+    }
+
+    static local_iterator end(segment_iterator s) {
+        return s._dir[s._k] + (SegVec::_mask + 1);
+    }
+
+    static _iter_t compose(segment_iterator s, local_iterator l) {
+        return _iter_t(s._dir, (s._k << SegVec::_shift) + (l - s._dir[s._k]));
+    }
+};
+
+// Elements in chunks of chunk_size, a power of two, reached through a
+// directory of chunk pointers. Growth adds chunks and never moves an
+// element, references stay valid until the element is erased. Iterators
+// hold the directory and are invalidated by growth, as in std::deque.
+template<class T, class Alloc = allocator<T>,
+         size_t Shift = _segment_shift<T>::value>
+class segmented_vector {
+public:
+    // types:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using _alloc_traits = allocator_traits<allocator_type>;
+    using size_type = typename _alloc_traits::size_type;
+    using difference_type = typename _alloc_traits::difference_type;
+    using pointer = typename _alloc_traits::pointer;
+    using const_pointer = typename _alloc_traits::const_pointer;
+    using iterator = segmented_vector_iterator<value_type, segmented_vector>;
+    using const_iterator =
+        segmented_vector_iterator<const value_type, segmented_vector>;
+    using reverse_iterator = ala::reverse_iterator<iterator>;
+    using const_reverse_iterator = ala::reverse_iterator<const_iterator>;
+    static_assert(is_same<value_type, typename _alloc_traits::value_type>::value,
+                  "allocator::value_type mismatch");
+    static_assert(is_pointer<pointer>::value,
+                  "chunk directory needs an allocator of raw pointers");
+
+    static constexpr size_type chunk_size = size_type(1) << Shift;
+    static constexpr size_type _shift = Shift;
+    static constexpr size_type _mask = chunk_size - 1;
+
+protected:
+    using _dir_alloc =
+        typename _alloc_traits::template rebind_alloc<pointer>;
+    using holder_t = pointer_holder<pointer, Alloc>;
+    using _plain_t = _is_plain_construct<allocator_type>;
+
+    allocator_type _alloc;
+    vector<pointer, _dir_alloc> _dir;
+    size_type _size = 0;
+
+    pointer _at(size_type i) const noexcept {
+        return _dir[i >> Shift] + (i & _mask);
+    }
+
+    template<class... V>
+    pointer v_fill(pointer first, pointer last, V &&...v) {
+        static_assert(sizeof...(V) == 0 || sizeof...(V) == 1, "Internal error");
+        return this->do_fill(first, last, _plain_t{}, ala::forward<V>(v)...);
+    }
+
+    template<class... V>
+    pointer do_fill(pointer first, pointer last, false_type, V &&...v) {
+        pointer i = first;
+        try {
+            for (; i != last; ++i)
+                _alloc_traits::construct(_alloc, i, ala::forward<V>(v)...);
+        } catch (...) {
+            for (; i != first;)
+                _alloc_traits::destroy(_alloc, --i);
+            throw;
+        }
+        return i;
+    }
+
+    pointer do_fill(pointer first, pointer last, true_type) {
+        ala::uninitialized_value_construct(first, last);
+        return last;
+    }
+
+    template<class V>
+    pointer do_fill(pointer first, pointer last, true_type, V &&v) {
+        ala::uninitialized_fill(first, last, v);
+        return last;
+    }
+
+    template<class InputIter>
+    void cp(InputIter first, InputIter last, pointer out) {
+        this->cp(first, last, out, _plain_t{});
+    }
+
+    template<class InputIter>
+    void cp(InputIter first, InputIter last, pointer out, false_type) {
+        pointer i = out;
+        try {
+            for (; first != last; ++first, (void)++i)
+                _alloc_traits::construct(_alloc, i, *first);
+        } catch (...) {
+            for (; i != out;)
+                _alloc_traits::destroy(_alloc, --i);
+            throw;
+        }
+    }
+
+    template<class InputIter>
+    void cp(InputIter first, InputIter last, pointer out, true_type) {
+        ala::uninitialized_copy(first, last, out);
+    }
+
+    void cut(size_type n) noexcept {
+        for (size_type i = n; i != _size; ++i)
+            _alloc_traits::destroy(_alloc, this->_at(i));
+        _size = n;
+    }
+
+    void add_chunk() {
+        holder_t holder(_alloc, chunk_size);
+        _dir.push_back(holder.get());
+        holder.release();
+    }
+
+    // chunks past the first keep are given back
+    void free_chunks(size_type keep) noexcept {
+        while (_dir.size() > keep) {
+            _alloc.deallocate(_dir.back(), chunk_size);
+            _dir.pop_back();
+        }
+    }
+
+    void destroy() noexcept {
+        clear();
+        this->free_chunks(0);
+    }
+
+    // n values from v... at the end, chunk by chunk
+    template<class... V>
+    void v_append(size_type n, V &&...v) {
+        this->reserve(size() + n);
+        size_type sz = size(), new_size = sz + n;
+        try {
+            while (_size != new_size) {
+                size_type k = chunk_size - (_size & _mask);
+                if (k > new_size - _size)
+                    k = new_size - _size;
+                pointer p = this->_at(_size);
+                this->v_fill(p, p + k, ala::forward<V>(v)...);
+                _size += k;
+            }
+        } catch (...) {
+            this->cut(sz);
+            throw;
+        }
+    }
+
+    // n elements from first at the end, chunk by chunk
+    template<class ForwardIter>
+    void append_n(ForwardIter first, size_type n) {
+        this->reserve(size() + n);
+        size_type sz = size(), new_size = sz + n;
+        try {
+            while (_size != new_size) {
+                size_type k = chunk_size - (_size & _mask);
+                if (k > new_size - _size)
+                    k = new_size - _size;
+                ForwardIter mid = ala::next(first, k);
+                this->cp(first, mid, this->_at(_size));
+                first = mid;
+                _size += k;
+            }
+        } catch (...) {
+            this->cut(sz);
+            throw;
+        }
+    }
+
+    template<class InputIter>
+    enable_if_t<!is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value>
+    append(InputIter first, InputIter last) {
+        for (; first != last; ++first)
+            this->emplace_back(*first);
+    }
+
+    template<class ForwardIter>
+    enable_if_t<is_base_of<forward_iterator_tag, _iter_tag_t<ForwardIter>>::value>
+    append(ForwardIter first, ForwardIter last) {
+        this->append_n(first, ala::distance(first, last));
+    }
+
+    void possess(segmented_vector &&other) noexcept {
+        _dir = ala::move(other._dir);
+        _size = other._size;
+        other._size = 0;
+    }
+
+public:
+    // construct/copy/destroy:
+    segmented_vector() noexcept(
+        is_nothrow_default_constructible<allocator_type>::value)
+        : _dir(_dir_alloc(_alloc)) {}
+
+    explicit segmented_vector(const allocator_type &a) noexcept
+        : _alloc(a), _dir(_dir_alloc(_alloc)) {}
+
+    explicit segmented_vector(size_type n,
+                              const allocator_type &a = allocator_type())
+        : segmented_vector(a) {
+        this->v_append(n);
+    }
+
+    segmented_vector(size_type n, const value_type &v,
+                     const allocator_type &a = allocator_type())
+        : segmented_vector(a) {
+        this->v_append(n, v);
+    }
+
+    template<class InputIter,
+             typename = enable_if_t<
+                 is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value>>
+    segmented_vector(InputIter first, InputIter last,
+                     const allocator_type &a = allocator_type())
+        : segmented_vector(a) {
+        this->append(first, last);
+    }
+
+    segmented_vector(const segmented_vector &other)
+        : segmented_vector(
+              _alloc_traits::select_on_container_copy_construction(
+                  other._alloc)) {
+        this->append_n(other.begin(), other.size());
+    }
+
+    segmented_vector(segmented_vector &&other) noexcept
+        : _alloc(ala::move(other._alloc)), _dir(ala::move(other._dir)),
+          _size(other._size) {
+        other._size = 0;
+    }
+
+    segmented_vector(const segmented_vector &other,
+                     const type_identity_t<allocator_type> &a)
+        : segmented_vector(a) {
+        this->append_n(other.begin(), other.size());
+    }
+
+    segmented_vector(segmented_vector &&other,
+                     const type_identity_t<allocator_type> &a)
+        : segmented_vector(a) {
+        if (_alloc == other._alloc)
+            this->possess(ala::move(other));
+        else
+            this->append_n(ala::make_move_iterator(other.begin()),
+                           other.size());
+    }
+
+    segmented_vector(initializer_list<value_type> il,
+                     const allocator_type &a = allocator_type())
+        : segmented_vector(il.begin(), il.end(), a) {}
+
+    ~segmented_vector() {
+        destroy();
+    }
+
+protected:
+    template<bool Dummy = _alloc_traits::propagate_on_container_copy_assignment::value>
+    enable_if_t<Dummy> copy_helper(const segmented_vector &other) {
+        if (_alloc != other._alloc) {
+            destroy();
+            _alloc = other._alloc;
+            _dir = vector<pointer, _dir_alloc>(_dir_alloc(_alloc));
+        }
+        this->assign(other.begin(), other.end());
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_copy_assignment::value>
+    enable_if_t<!Dummy> copy_helper(const segmented_vector &other) {
+        this->assign(other.begin(), other.end());
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_move_assignment::value>
+    enable_if_t<Dummy> move_helper(segmented_vector &&other) {
+        destroy();
+        _alloc = ala::move(other._alloc);
+        this->possess(ala::move(other));
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_move_assignment::value>
+    enable_if_t<!Dummy> move_helper(segmented_vector &&other) {
+        if (_alloc == other._alloc) {
+            destroy();
+            this->possess(ala::move(other));
+        } else {
+            this->assign(ala::make_move_iterator(other.begin()),
+                         ala::make_move_iterator(other.end()));
+        }
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_swap::value>
+    enable_if_t<Dummy> swap_helper(segmented_vector &other) noexcept {
+        ala::_swap_adl(_alloc, other._alloc);
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_swap::value>
+    enable_if_t<!Dummy> swap_helper(segmented_vector &other) noexcept {
+        assert(_alloc == other._alloc);
+    }
+
+public:
+    segmented_vector &operator=(const segmented_vector &other) {
+        if (this != ala::addressof(other))
+            copy_helper(other);
+        return *this;
+    }
+
+    segmented_vector &operator=(segmented_vector &&other) noexcept(
+        _alloc_traits::propagate_on_container_move_assignment::value ||
+        _alloc_traits::is_always_equal::value) {
+        if (this != ala::addressof(other))
+            move_helper(ala::move(other));
+        return *this;
+    }
+
+    segmented_vector &operator=(initializer_list<value_type> il) {
+        this->assign(il.begin(), il.end());
+        return *this;
+    }
+
+    void swap(segmented_vector &other) noexcept(
+        _alloc_traits::propagate_on_container_swap::value ||
+        _alloc_traits::is_always_equal::value) {
+        this->swap_helper(other);
+        _dir.swap(other._dir);
+        ala::_swap_adl(_size, other._size);
+    }
+
+    template<class InputIter>
+    enable_if_t<is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value>
+    assign(InputIter first, InputIter last) {
+        size_type i = 0;
+        for (; first != last && i < size(); ++first, (void)++i)
+            *this->_at(i) = *first;
+        if (i < size())
+            this->cut(i);
+        this->append(first, last);
+    }
+
+    void assign(size_type n, const value_type &v) {
+        size_type i = 0;
+        for (; n > 0 && i != size(); --n, (void)++i)
+            *this->_at(i) = v;
+        if (i != size())
+            this->cut(i);
+        this->v_append(n, v);
+    }
+
+    void assign(initializer_list<value_type> il) {
+        this->assign(il.begin(), il.end());
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return _alloc;
+    }
+
+    // iterator:
+    iterator begin() noexcept {
+        return iterator(_dir.data(), 0);
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    iterator end() noexcept {
+        return iterator(_dir.data(), size());
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return crbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return crend();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_iterator(_dir.data(), 0);
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator(_dir.data(), size());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(cend());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(cbegin());
+    }
+
+    // capacity:
+    size_type size() const noexcept {
+        return _size;
+    }
+
+    size_type max_size() const noexcept {
+        return _alloc_traits::max_size(_alloc);
+    }
+
+    void resize(size_type n) {
+        if (size() > n)
+            this->cut(n);
+        else
+            this->v_append(n - size());
+    }
+
+    void resize(size_type n, const value_type &v) {
+        if (size() > n)
+            this->cut(n);
+        else
+            this->v_append(n - size(), v);
+    }
+
+    size_type capacity() const noexcept {
+        return _dir.size() << Shift;
+    }
+
+    ALA_NODISCARD bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    // allocates the chunks up front, later growth up to n neither allocates
+    // nor invalidates iterators
+    void reserve(size_type n) {
+        size_type chunks = (n + _mask) >> Shift;
+        if (chunks <= _dir.size())
+            return;
+        _dir.reserve(chunks);
+        while (_dir.size() < chunks)
+            this->add_chunk();
+    }
+
+    void shrink_to_fit() {
+        this->free_chunks((size() + _mask) >> Shift);
+        _dir.shrink_to_fit();
+    }
+
+    // element access:
+    reference operator[](size_type n) {
+        return *this->_at(n);
+    }
+
+    const_reference operator[](size_type n) const {
+        return *this->_at(n);
+    }
+
+    reference at(size_type n) {
+        if (!(n < size()))
+            throw out_of_range("ala::segmented_vector index out of range");
+        return *this->_at(n);
+    }
+
+    const_reference at(size_type n) const {
+        if (!(n < size()))
+            throw out_of_range("ala::segmented_vector index out of range");
+        return *this->_at(n);
+    }
+
+    reference front() {
+        return *_dir[0];
+    }
+
+    const_reference front() const {
+        return *_dir[0];
+    }
+
+    reference back() {
+        return *this->_at(_size - 1);
+    }
+
+    const_reference back() const {
+        return *this->_at(_size - 1);
+    }
+
+    // modifiers:
+    template<class... Args>
+    reference emplace_back(Args &&...args) {
+        if (ALA_UNEXPECT(size() == capacity()))
+            this->add_chunk();
+        pointer p = this->_at(_size);
+        _alloc_traits::construct(_alloc, p, ala::forward<Args>(args)...);
+        ++_size;
+        return *p;
+    }
+
+    void push_back(const value_type &v) {
+        this->emplace_back(v);
+    }
+
+    void push_back(value_type &&v) {
+        this->emplace_back(ala::move(v));
+    }
+
+    void pop_back() {
+        _alloc_traits::destroy(_alloc, this->_at(_size - 1));
+        --_size;
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator position, Args &&...args) {
+        difference_type offset = position - cbegin();
+        this->emplace_back(ala::forward<Args>(args)...);
+        ala::rotate(begin() + offset, end() - 1, end());
+        return begin() + offset;
+    }
+
+    iterator insert(const_iterator position, const value_type &v) {
+        return this->emplace(position, v);
+    }
+
+    iterator insert(const_iterator position, value_type &&v) {
+        return this->emplace(position, ala::move(v));
+    }
+
+    iterator insert(const_iterator position, size_type n, const value_type &v) {
+        difference_type offset = position - cbegin();
+        this->v_append(n, v);
+        ala::rotate(begin() + offset, end() - n, end());
+        return begin() + offset;
+    }
+
+    template<class InputIter>
+    enable_if_t<is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value,
+                iterator>
+    insert(const_iterator position, InputIter first, InputIter last) {
+        difference_type offset = position - cbegin();
+        size_type sz = size();
+        this->append(first, last);
+        ala::rotate(begin() + offset, begin() + sz, end());
+        return begin() + offset;
+    }
+
+    iterator insert(const_iterator position, initializer_list<value_type> il) {
+        return this->insert(position, il.begin(), il.end());
+    }
+
+    iterator erase(const_iterator position) {
+        return this->erase(position, position + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        iterator left = begin() + (first - cbegin());
+        if (first == last)
+            return left;
+        iterator rght = begin() + (last - cbegin());
+        iterator e = ala::move(rght, end(), left);
+        this->cut(e - begin());
+        return left;
+    }
+
+    void clear() noexcept {
+        this->cut(0);
+    }
+};
+
+template<class T, class Alloc, size_t Shift>
+constexpr typename segmented_vector<T, Alloc, Shift>::size_type
+    segmented_vector<T, Alloc, Shift>::chunk_size;
+
+template<class T, class Alloc, size_t Shift>
+bool operator==(const segmented_vector<T, Alloc, Shift> &lhs,
+                const segmented_vector<T, Alloc, Shift> &rhs) {
+    if (lhs.size() == rhs.size())
+        return ala::equal(lhs.begin(), lhs.end(), rhs.begin());
+    return false;
+}
+
+template<class T, class Alloc, size_t Shift>
+bool operator!=(const segmented_vector<T, Alloc, Shift> &lhs,
+                const segmented_vector<T, Alloc, Shift> &rhs) {
+    return !(lhs == rhs);
+}
+
+template<class T, class Alloc, size_t Shift>
+bool operator<(const segmented_vector<T, Alloc, Shift> &lhs,
+               const segmented_vector<T, Alloc, Shift> &rhs) {
+    return ala::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                        rhs.end());
+}
+
+template<class T, class Alloc, size_t Shift>
+bool operator>(const segmented_vector<T, Alloc, Shift> &lhs,
+               const segmented_vector<T, Alloc, Shift> &rhs) {
+    return rhs < lhs;
+}
+
+template<class T, class Alloc, size_t Shift>
+bool operator<=(const segmented_vector<T, Alloc, Shift> &lhs,
+                const segmented_vector<T, Alloc, Shift> &rhs) {
+    return !(rhs < lhs);
+}
+
+template<class T, class Alloc, size_t Shift>
+bool operator>=(const segmented_vector<T, Alloc, Shift> &lhs,
+                const segmented_vector<T, Alloc, Shift> &rhs) {
+    return !(lhs < rhs);
+}
+
+template<class T, class Alloc, size_t Shift>
+void swap(segmented_vector<T, Alloc, Shift> &lhs,
+          segmented_vector<T, Alloc, Shift> &rhs) noexcept(
+    noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template<class T, class Alloc, size_t Shift, class U>
+typename segmented_vector<T, Alloc, Shift>::size_type
+erase(segmented_vector<T, Alloc, Shift> &c, const U &value) {
+    using iter_t = typename segmented_vector<T, Alloc, Shift>::iterator;
+    using diff_t = typename segmented_vector<T, Alloc, Shift>::difference_type;
+    iter_t i = ala::remove(c.begin(), c.end(), value);
+    diff_t n = ala::distance(i, c.end());
+    c.erase(i, c.end());
+    return n;
+}
+
+template<class T, class Alloc, size_t Shift, class Pred>
+typename segmented_vector<T, Alloc, Shift>::size_type
+erase_if(segmented_vector<T, Alloc, Shift> &c, Pred pred) {
+    using iter_t = typename segmented_vector<T, Alloc, Shift>::iterator;
+    using diff_t = typename segmented_vector<T, Alloc, Shift>::difference_type;
+    iter_t i = ala::remove_if(c.begin(), c.end(), pred);
+    diff_t n = ala::distance(i, c.end());
+    c.erase(i, c.end());
+    return n;
+}
+
+} // namespace ala
+
+#endif // HEAD
@@ -0,0 +1,896 @@
+#ifndef _ALA_SMALL_VECTOR_H
+#define _ALA_SMALL_VECTOR_H
+
+#include <ala/detail/algorithm_base.h>
+#include <ala/detail/allocator.h>
+#include <ala/detail/ptr_iterator.h>
+#include <ala/span.h>
+
+namespace ala {
+
+// vector that keeps up to N elements in storage of its own and allocates
+// only beyond them. A spilled small_vector owns a heap buffer as vector
+// does, moves steal it. Moves of an unspilled one move the elements, and
+// iterators are not kept valid across them or swap.
+template<class T, size_t N, class Alloc = allocator<T>>
+class small_vector {
+public:
+    // types:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using _alloc_traits = allocator_traits<allocator_type>;
+    using size_type = typename _alloc_traits::size_type;
+    using difference_type = typename _alloc_traits::difference_type;
+    using pointer = typename _alloc_traits::pointer;
+    using const_pointer = typename _alloc_traits::const_pointer;
+    using iterator = ptr_iterator<value_type, pointer>;
+    using const_iterator = ptr_iterator<const value_type, const_pointer>;
+    using reverse_iterator = ala::reverse_iterator<iterator>;
+    using const_reverse_iterator = ala::reverse_iterator<const_iterator>;
+    static_assert(is_same<value_type, typename _alloc_traits::value_type>::value,
+                  "allocator::value_type mismatch");
+    static_assert(is_pointer<pointer>::value,
+                  "inline storage needs an allocator of raw pointers");
+
+protected:
+    pointer _data = this->_inline();
+    size_type _capacity = N;
+    size_type _size = 0;
+    allocator_type _alloc;
+    alignas(value_type) unsigned char _buf[(N ? N : 1) * sizeof(value_type)];
+    using holder_t = pointer_holder<pointer, Alloc>;
+    using _plain_t = _is_plain_construct<allocator_type>;
+
+    pointer _inline() noexcept {
+        return reinterpret_cast<pointer>(_buf);
+    }
+
+    bool _is_inline() const noexcept {
+        return _data == reinterpret_cast<const value_type *>(_buf);
+    }
+
+    void update(pointer m, size_type capacity, size_type size) {
+        assert(m != _data);
+        _data = m;
+        _capacity = capacity;
+        _size = size;
+    }
+
+    template<class... V>
+    pointer v_fill(pointer first, pointer last, V &&...v) {
+        static_assert(sizeof...(V) == 0 || sizeof...(V) == 1, "Internal error");
+        return this->do_fill(first, last, _plain_t{}, ala::forward<V>(v)...);
+    }
+
+    template<class... V>
+    pointer do_fill(pointer first, pointer last, false_type, V &&...v) {
+        pointer i = first;
+        try {
+            for (; i != last; ++i)
+                _alloc_traits::construct(_alloc, i, ala::forward<V>(v)...);
+        } catch (...) {
+            for (; i != first;)
+                _alloc_traits::destroy(_alloc, --i);
+            throw;
+        }
+        return i;
+    }
+
+    pointer do_fill(pointer first, pointer last, true_type) {
+        ala::uninitialized_value_construct(first, last);
+        return last;
+    }
+
+    template<class V>
+    pointer do_fill(pointer first, pointer last, true_type, V &&v) {
+        ala::uninitialized_fill(first, last, v);
+        return last;
+    }
+
+    template<class InputIter>
+    void mv(InputIter first, InputIter last, pointer out) {
+        this->mv(first, last, out, _plain_t{});
+    }
+
+    template<class InputIter>
+    void mv(InputIter first, InputIter last, pointer out, false_type) {
+        pointer i = out;
+        try {
+            for (; first != last; ++first, (void)++i)
+                _alloc_traits::construct(_alloc, i, ala::move(*first));
+        } catch (...) {
+            for (; i != out;)
+                _alloc_traits::destroy(_alloc, --i);
+            throw;
+        }
+    }
+
+    template<class InputIter>
+    void mv(InputIter first, InputIter last, pointer out, true_type) {
+        ala::uninitialized_move(first, last, out);
+    }
+
+    template<class InputIter>
+    void cp(InputIter first, InputIter last, pointer out) {
+        this->cp(first, last, out, _plain_t{});
+    }
+
+    template<class InputIter>
+    void cp(InputIter first, InputIter last, pointer out, false_type) {
+        pointer i = out;
+        try {
+            for (; first != last; ++first, (void)++i)
+                _alloc_traits::construct(_alloc, i, *first);
+        } catch (...) {
+            for (; i != out;)
+                _alloc_traits::destroy(_alloc, --i);
+            throw;
+        }
+    }
+
+    template<class InputIter>
+    void cp(InputIter first, InputIter last, pointer out, true_type) {
+        ala::uninitialized_copy(first, last, out);
+    }
+
+    template<class InputIter, class Dummy = value_type>
+    enable_if_t<(is_nothrow_move_constructible<Dummy>::value ||
+                 !is_copy_constructible<Dummy>::value)>
+    migrate(InputIter first, InputIter last, pointer dst) {
+        return this->mv(first, last, dst);
+    }
+
+    template<class InputIter, class Dummy = value_type>
+    enable_if_t<!(is_nothrow_move_constructible<Dummy>::value ||
+                  !is_copy_constructible<Dummy>::value)>
+    migrate(InputIter first, InputIter last, pointer dst) {
+        return this->cp(first, last, dst);
+    }
+
+    void migrate(pointer dst) {
+        return this->migrate(begin(), end(), dst);
+    }
+
+    // [begin, mid) move(copy) to dst1, [mid, end) move(copy) to dst2
+    void migrate2(pointer mid, pointer dst1, pointer dst2) {
+        this->migrate((pointer)begin(), mid, dst1);
+        this->migrate(mid, (pointer)end(), dst2);
+    }
+
+    void cut(pointer position) noexcept {
+        pointer e = end();
+        for (; position != e; ++position, (void)--_size)
+            _alloc_traits::destroy(_alloc, position);
+    }
+
+    void realloc(size_type n) {
+        holder_t holder(_alloc, n);
+        this->migrate(holder.get());
+        size_t sz = size();
+        this->destroy();
+        this->update(holder.release(), n, sz);
+    }
+
+    size_type expand() {
+        size_type c = capacity();
+        return c + (c >> 1) + 1;
+    }
+
+    size_type expand2() {
+        size_type c = capacity();
+        return (c << 1) + 1;
+    }
+
+    // [first, last) into empty storage of at least n elements
+    template<class InputIter>
+    void copy_init(size_type n, InputIter first, InputIter last) {
+        if (n <= capacity()) {
+            this->cp(first, last, _data);
+            _size = n;
+            return;
+        }
+        holder_t holder(_alloc, n);
+        this->cp(first, last, holder.get());
+        this->update(holder.release(), n, n);
+    }
+
+    void clone(const small_vector &other) {
+        this->copy_init(other.size(), other.begin(), other.end());
+    }
+
+    void clone(small_vector &&other) {
+        this->copy_init(other.size(), ala::make_move_iterator(other.begin()),
+                        ala::make_move_iterator(other.end()));
+    }
+
+    // other spilled gives up its buffer, an unspilled one its elements
+    void possess(small_vector &&other) {
+        if (other._is_inline()) {
+            this->mv(other.begin(), other.end(), _data);
+            _size = other._size;
+            other.clear();
+            return;
+        }
+        _capacity = other._capacity;
+        _data = other._data;
+        _size = other._size;
+        other._capacity = N;
+        other._data = other._inline();
+        other._size = 0;
+    }
+
+    void destroy() {
+        clear();
+        if (!this->_is_inline())
+            _alloc.deallocate(_data, _capacity);
+        _data = this->_inline();
+        _capacity = N;
+    }
+
+    template<class InputIter>
+    enable_if_t<!is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value>
+    iter_ctor_helper(InputIter first, InputIter last) {
+        for (; first != last; ++first)
+            this->emplace_back(*first);
+    }
+
+    template<class ForwardIter>
+    enable_if_t<is_base_of<forward_iterator_tag, _iter_tag_t<ForwardIter>>::value>
+    iter_ctor_helper(ForwardIter first, ForwardIter last) {
+        size_type new_size = ala::distance(first, last);
+        if (new_size < 1)
+            return;
+        this->copy_init(new_size, first, last);
+    }
+
+    template<class... V>
+    void v_ctor_helper(size_type n, V &&...v) {
+        if (n < 1)
+            return;
+        if (n <= capacity()) {
+            this->v_fill(_data, _data + n, ala::forward<V>(v)...);
+            _size = n;
+            return;
+        }
+        holder_t holder(_alloc, n);
+        this->v_fill(holder.get(), holder.get() + n, ala::forward<V>(v)...);
+        this->update(holder.release(), n, n);
+    }
+
+public:
+    // construct/copy/destroy:
+    small_vector() noexcept(
+        is_nothrow_default_constructible<allocator_type>::value) {}
+
+    explicit small_vector(const allocator_type &a) noexcept: _alloc(a) {}
+
+    explicit small_vector(size_type n,
+                          const allocator_type &a = allocator_type())
+        : _alloc(a) {
+        this->v_ctor_helper(n);
+    }
+
+    small_vector(size_type n, const value_type &v,
+                 const allocator_type &a = allocator_type())
+        : _alloc(a) {
+        this->v_ctor_helper(n, v);
+    }
+
+    template<class InputIter,
+             typename = enable_if_t<
+                 is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value>>
+    small_vector(InputIter first, InputIter last,
+                 const allocator_type &a = allocator_type())
+        : _alloc(a) {
+        this->iter_ctor_helper(first, last);
+    }
+
+    template<class U, size_t Extent>
+    explicit small_vector(span<U, Extent> s,
+                          const allocator_type &a = allocator_type())
+        : small_vector(s.begin(), s.end(), a) {}
+
+    small_vector(const small_vector &other)
+        : _alloc(_alloc_traits::select_on_container_copy_construction(
+              other._alloc)) {
+        this->clone(other);
+    }
+
+    small_vector(small_vector &&other) noexcept(
+        is_nothrow_move_constructible<value_type>::value)
+        : _alloc(ala::move(other._alloc)) {
+        this->possess(ala::move(other));
+    }
+
+    small_vector(const small_vector &other,
+                 const type_identity_t<allocator_type> &a)
+        : _alloc(a) {
+        this->clone(other);
+    }
+
+    small_vector(small_vector &&other, const type_identity_t<allocator_type> &a)
+        : _alloc(a) {
+        if (_alloc == other._alloc)
+            this->possess(ala::move(other));
+        else
+            this->clone(ala::move(other));
+    }
+
+    small_vector(initializer_list<value_type> il,
+                 const allocator_type &a = allocator_type())
+        : small_vector(il.begin(), il.end(), a) {}
+
+    ~small_vector() {
+        destroy();
+    }
+
+protected:
+    template<bool Dummy = _alloc_traits::propagate_on_container_copy_assignment::value>
+    enable_if_t<Dummy> copy_helper(const small_vector &other) {
+        if (_alloc != other._alloc)
+            destroy();
+        _alloc = other._alloc;
+        this->assign(other.begin(), other.end());
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_copy_assignment::value>
+    enable_if_t<!Dummy> copy_helper(const small_vector &other) {
+        this->assign(other.begin(), other.end());
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_move_assignment::value>
+    enable_if_t<Dummy> move_helper(small_vector &&other) {
+        destroy();
+        _alloc = ala::move(other._alloc);
+        this->possess(ala::move(other));
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_move_assignment::value>
+    enable_if_t<!Dummy> move_helper(small_vector &&other) {
+        if (_alloc == other._alloc) {
+            destroy();
+            this->possess(ala::move(other));
+        } else {
+            this->assign(ala::make_move_iterator(other.begin()),
+                         ala::make_move_iterator(other.end()));
+        }
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_swap::value>
+    enable_if_t<Dummy> swap_helper(small_vector &other) noexcept {
+        ala::_swap_adl(_alloc, other._alloc);
+    }
+
+    template<bool Dummy = _alloc_traits::propagate_on_container_swap::value>
+    enable_if_t<!Dummy> swap_helper(small_vector &other) noexcept {
+        assert(_alloc == other._alloc);
+    }
+
+    // both unspilled, the common prefix is swapped, the rest of the longer
+    // moved over
+    void swap_inline(small_vector &other) {
+        small_vector *a = this, *b = &other;
+        if (a->size() > b->size())
+            ala::swap(a, b);
+        pointer ad = a->_data, bd = b->_data;
+        size_type k = a->size();
+        ala::swap_ranges(ad, ad + k, bd);
+        a->mv(bd + k, bd + b->size(), ad + k);
+        a->_size = b->_size;
+        b->cut(bd + k);
+    }
+
+    // this spilled, other not, other's elements go to this storage and the
+    // buffer to other
+    void swap_spilled(small_vector &other) {
+        pointer p = _data;
+        size_type capa = _capacity, sz = _size;
+        _data = this->_inline();
+        _capacity = N;
+        _size = 0;
+        try {
+            this->mv(other.begin(), other.end(), _data);
+        } catch (...) {
+            _data = p;
+            _capacity = capa;
+            _size = sz;
+            throw;
+        }
+        _size = other._size;
+        other.clear();
+        other._data = p;
+        other._capacity = capa;
+        other._size = sz;
+    }
+
+public:
+    small_vector &operator=(const small_vector &other) {
+        if (this != ala::addressof(other))
+            copy_helper(other);
+        return *this;
+    }
+
+    small_vector &operator=(small_vector &&other) noexcept(
+        is_nothrow_move_constructible<value_type>::value &&
+        (_alloc_traits::propagate_on_container_move_assignment::value ||
+         _alloc_traits::is_always_equal::value)) {
+        if (this != ala::addressof(other))
+            move_helper(ala::move(other));
+        return *this;
+    }
+
+    small_vector &operator=(initializer_list<value_type> il) {
+        this->assign(il.begin(), il.end());
+        return *this;
+    }
+
+    void swap(small_vector &other) noexcept(
+        is_nothrow_move_constructible<value_type>::value &&
+        is_nothrow_swappable<value_type>::value &&
+        (_alloc_traits::propagate_on_container_swap::value ||
+         _alloc_traits::is_always_equal::value)) {
+        if (this == ala::addressof(other))
+            return;
+        this->swap_helper(other);
+        if (!this->_is_inline() && !other._is_inline()) {
+            ala::swap(_data, other._data);
+            ala::_swap_adl(_capacity, other._capacity);
+            ala::_swap_adl(_size, other._size);
+        } else if (this->_is_inline() && other._is_inline()) {
+            this->swap_inline(other);
+        } else if (this->_is_inline()) {
+            other.swap_spilled(*this);
+        } else {
+            this->swap_spilled(other);
+        }
+    }
+
+protected:
+    template<class Size, class InputIter>
+    void assign_realloc(Size n, InputIter first, InputIter last) {
+        holder_t holder(_alloc, n);
+        this->cp(first, last, holder.get());
+        this->destroy();
+        this->update(holder.release(), n, n);
+    }
+
+    template<class InputIter>
+    void assign_norealloc(InputIter first, InputIter last) {
+        size_type i = 0;
+        for (; first != last && i < size(); ++first, (void)++i)
+            *(_data + i) = *first;
+        if (i < size())
+            this->cut(begin() + i);
+        if (first != last)
+            this->insert(cend(), first, last);
+    }
+
+    void assign_nv_realloc(size_type n, const value_type &v) {
+        holder_t holder(_alloc, n);
+        this->v_fill(holder.get(), holder.get() + n, v);
+        this->destroy();
+        this->update(holder.release(), n, n);
+    }
+
+    void assign_nv_norealloc(size_type n, const value_type &v) {
+        size_type i = 0;
+        for (; n > 0 && i != size(); --n, (void)++i)
+            *(_data + i) = v;
+        if (i != size())
+            this->cut(begin() + i);
+        if (n > 0)
+            this->insert(end(), n, v);
+    }
+
+public:
+    template<class InputIter>
+    enable_if_t<is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value &&
+                is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value>
+    assign(InputIter first, InputIter last) {
+        size_type len = ala::distance(first, last);
+        if (len > capacity())
+            this->assign_realloc(len, first, last);
+        else
+            this->assign_norealloc(first, last);
+    }
+
+    template<class InputIter>
+    enable_if_t<is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value &&
+                !is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value>
+    assign(InputIter first, InputIter last) {
+        this->assign_norealloc(first, last);
+    }
+
+    void assign(size_type n, const value_type &v) {
+        if (n > capacity())
+            this->assign_nv_realloc(n, v);
+        else
+            this->assign_nv_norealloc(n, v);
+    }
+
+    void assign(initializer_list<value_type> il) {
+        this->assign(il.begin(), il.end());
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return _alloc;
+    }
+
+    // iterator:
+    iterator begin() noexcept {
+        return _data;
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    iterator end() noexcept {
+        return _data + size();
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return crbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return crend();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_iterator(const_cast<small_vector *>(this)->begin());
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator(const_cast<small_vector *>(this)->end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(cend());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(cbegin());
+    }
+
+    // capacity:
+    size_type size() const noexcept {
+        return _size;
+    }
+
+    size_type max_size() const noexcept {
+        return _alloc_traits::max_size(_alloc);
+    }
+
+protected:
+    template<class... V>
+    void v_resize(size_type n, V &&...v) {
+        if (size() > n) {
+            this->cut(begin() + n);
+        } else if (n > capacity()) {
+            holder_t holder(_alloc, n);
+            this->v_fill(holder.get() + size(), holder.get() + n,
+                         ala::forward<V>(v)...);
+            this->migrate(holder.get());
+            this->destroy();
+            this->update(holder.release(), n, n);
+        } else {
+            difference_type diff = n - size();
+            this->v_fill(end(), end() + diff, ala::forward<V>(v)...);
+            _size += diff;
+        }
+    }
+
+public:
+    void resize(size_type n) {
+        this->v_resize(n);
+    }
+
+    void resize(size_type n, const value_type &v) {
+        this->v_resize(n, v);
+    }
+
+    size_type capacity() const noexcept {
+        return _capacity;
+    }
+
+    ALA_NODISCARD bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    void reserve(size_type n) {
+        if (n > capacity())
+            this->realloc(n);
+    }
+
+    // back to the inline storage when the elements fit
+    void shrink_to_fit() {
+        if (this->_is_inline() || capacity() == size())
+            return;
+        if (size() > N)
+            return this->realloc(size());
+        size_type sz = size();
+        this->migrate(this->_inline());
+        this->destroy();
+        _size = sz;
+    }
+
+    // element access:
+    reference operator[](size_type n) {
+        return _data[n];
+    }
+
+    const_reference operator[](size_type n) const {
+        return _data[n];
+    }
+
+    reference at(size_type n) {
+        if (!(n < size()))
+            throw out_of_range("ala::small_vector index out of range");
+        return _data[n];
+    }
+
+    const_reference at(size_type n) const {
+        if (!(n < size()))
+            throw out_of_range("ala::small_vector index out of range");
+        return _data[n];
+    }
+
+    reference front() {
+        return _data[0];
+    }
+
+    const_reference front() const {
+        return _data[0];
+    }
+
+    reference back() {
+        return _data[_size - 1];
+    }
+
+    const_reference back() const {
+        return _data[_size - 1];
+    }
+
+    // data access:
+    value_type *data() noexcept {
+        return _data;
+    }
+
+    const value_type *data() const noexcept {
+        return _data;
+    }
+
+    // modifiers:
+    template<class... Args>
+    reference emplace_back(Args &&...args) {
+        size_type new_size = size() + 1;
+        if (ALA_UNEXPECT(new_size > capacity())) {
+            size_type new_capa = expand();
+            holder_t holder(_alloc, new_capa);
+            _alloc_traits::construct(_alloc, holder.get() + size(),
+                                     ala::forward<Args>(args)...);
+            this->migrate(holder.get());
+            this->destroy();
+            this->update(holder.release(), new_capa, new_size);
+        } else {
+            _alloc_traits::construct(_alloc, (pointer)end(),
+                                     ala::forward<Args>(args)...);
+            ++_size;
+        }
+        return back();
+    }
+
+    void push_back(const value_type &v) {
+        this->emplace_back(v);
+    }
+
+    void push_back(value_type &&v) {
+        this->emplace_back(ala::move(v));
+    }
+
+    void pop_back() {
+        _alloc_traits::destroy(_alloc, end() - 1);
+        --_size;
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator position, Args &&...args) {
+        difference_type offset = position - cbegin();
+        pointer pos = begin() + offset;
+        size_type new_size = size() + 1;
+        if (new_size > capacity()) {
+            size_type new_capa = expand();
+            holder_t holder(_alloc, new_capa);
+            pointer new_pos = holder.get() + offset;
+            _alloc_traits::construct(_alloc, new_pos,
+                                     ala::forward<Args>(args)...);
+            this->migrate2(pos, holder.get(), new_pos + 1);
+            this->destroy();
+            this->update(holder.release(), new_capa, new_size);
+        } else {
+            _alloc_traits::construct(_alloc, (pointer)end(),
+                                     ala::forward<Args>(args)...);
+            ++_size;
+            ala::rotate(begin() + offset, end() - 1, end());
+        }
+        return begin() + offset;
+    }
+
+    iterator insert(const_iterator position, const value_type &v) {
+        return this->emplace(position, v);
+    }
+
+    iterator insert(const_iterator position, value_type &&v) {
+        return this->emplace(position, ala::move(v));
+    }
+
+    iterator insert(const_iterator position, size_type n, const value_type &v) {
+        difference_type offset = position - cbegin();
+        pointer pos = begin() + offset;
+        size_type new_size = size() + n;
+        if (new_size > capacity()) {
+            size_type new_capa = new_size;
+            holder_t holder(_alloc, new_capa);
+            pointer new_pos = holder.get() + offset;
+            this->v_fill(new_pos, new_pos + n, v);
+            this->migrate2(pos, holder.get(), new_pos + n);
+            this->destroy();
+            this->update(holder.release(), new_capa, new_size);
+        } else {
+            this->v_fill(end(), end() + n, v);
+            _size += n;
+            ala::rotate(begin() + offset, end() - n, end());
+        }
+        return begin() + offset;
+    }
+
+    template<class InputIter>
+    enable_if_t<is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value &&
+                    is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value,
+                iterator>
+    insert(const_iterator position, InputIter first, InputIter last) {
+        size_type n = ala::distance(first, last);
+        difference_type offset = position - cbegin();
+        pointer pos = begin() + offset;
+        size_type new_size = size() + n;
+        if (new_size > capacity()) {
+            size_type new_capa = new_size;
+            holder_t holder(_alloc, new_capa);
+            pointer new_pos = holder.get() + offset;
+            this->cp(first, last, new_pos);
+            this->migrate2(pos, holder.get(), new_pos + n);
+            this->destroy();
+            this->update(holder.release(), new_capa, new_size);
+        } else {
+            this->cp(first, last, (pointer)end());
+            _size += n;
+            ala::rotate(begin() + offset, end() - n, end());
+        }
+        return begin() + offset;
+    }
+
+    template<class InputIter>
+    enable_if_t<is_base_of<input_iterator_tag, _iter_tag_t<InputIter>>::value &&
+                    !is_base_of<forward_iterator_tag, _iter_tag_t<InputIter>>::value,
+                iterator>
+    insert(const_iterator position, InputIter first, InputIter last) {
+        difference_type offset = position - cbegin();
+        for (; first != last; ++first, (void)++position)
+            position = this->emplace(position, *first);
+        return begin() + offset;
+    }
+
+    iterator insert(const_iterator position, initializer_list<value_type> il) {
+        return this->insert(position, il.begin(), il.end());
+    }
+
+    iterator erase(const_iterator position) {
+        pointer pos = begin() + (position - cbegin());
+        if (pos == end())
+            return end();
+        ala::move(pos + 1, (pointer)end(), pos);
+        pop_back();
+        return pos;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        pointer left = begin() + (first - cbegin());
+        pointer rght = begin() + (last - cbegin());
+        if (first == last)
+            return left;
+        difference_type n = rght - left;
+        ala::move(rght, (pointer)end(), left);
+        this->cut(end() - n);
+        return left;
+    }
+
+    void clear() noexcept {
+        this->cut(begin());
+    }
+};
+
+template<class T, size_t N, class Alloc>
+bool operator==(const small_vector<T, N, Alloc> &lhs,
+                const small_vector<T, N, Alloc> &rhs) {
+    if (lhs.size() == rhs.size())
+        return ala::equal(lhs.begin(), lhs.end(), rhs.begin());
+    return false;
+}
+
+template<class T, size_t N, class Alloc>
+bool operator!=(const small_vector<T, N, Alloc> &lhs,
+                const small_vector<T, N, Alloc> &rhs) {
+    return !(lhs == rhs);
+}
+
+template<class T, size_t N, class Alloc>
+bool operator<(const small_vector<T, N, Alloc> &lhs,
+               const small_vector<T, N, Alloc> &rhs) {
+    return ala::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                        rhs.end());
+}
+
+template<class T, size_t N, class Alloc>
+bool operator>(const small_vector<T, N, Alloc> &lhs,
+               const small_vector<T, N, Alloc> &rhs) {
+    return rhs < lhs;
+}
+
+template<class T, size_t N, class Alloc>
+bool operator<=(const small_vector<T, N, Alloc> &lhs,
+                const small_vector<T, N, Alloc> &rhs) {
+    return !(rhs < lhs);
+}
+
+template<class T, size_t N, class Alloc>
+bool operator>=(const small_vector<T, N, Alloc> &lhs,
+                const small_vector<T, N, Alloc> &rhs) {
+    return !(lhs < rhs);
+}
+
+template<class T, size_t N, class Alloc>
+void swap(small_vector<T, N, Alloc> &lhs,
+          small_vector<T, N, Alloc> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template<class T, size_t N, class Alloc, class U>
+typename small_vector<T, N, Alloc>::size_type
+erase(small_vector<T, N, Alloc> &c, const U &value) {
+    using iter_t = typename small_vector<T, N, Alloc>::iterator;
+    using diff_t = typename small_vector<T, N, Alloc>::difference_type;
+    iter_t i = ala::remove(c.begin(), c.end(), value);
+    diff_t n = ala::distance(i, c.end());
+    c.erase(i, c.end());
+    return n;
+}
+
+template<class T, size_t N, class Alloc, class Pred>
+typename small_vector<T, N, Alloc>::size_type
+erase_if(small_vector<T, N, Alloc> &c, Pred pred) {
+    using iter_t = typename small_vector<T, N, Alloc>::iterator;
+    using diff_t = typename small_vector<T, N, Alloc>::difference_type;
+    iter_t i = ala::remove_if(c.begin(), c.end(), pred);
+    diff_t n = ala::distance(i, c.end());
+    c.erase(i, c.end());
+    return n;
+}
+
+} // namespace ala
+
+#endif // HEAD
@@ -0,0 +1,725 @@
+#ifndef _ALA_SOA_VECTOR_H
+#define _ALA_SOA_VECTOR_H
+
+#include <ala/span.h>
+#include <ala/tuple.h>
+#include <ala/utility.h>
+#include <ala/vector.h>
+#include <ala/detail/sort.h>
+
+namespace ala {
+
+template<class SoA, bool Const>
+struct soa_vector_iterator {
+    using iterator_category = random_access_iterator_tag;
+    using value_type = typename SoA::value_type;
+    using difference_type = typename SoA::difference_type;
+    using size_type = typename SoA::size_type;
+    using reference = conditional_t<Const, typename SoA::const_reference,
+                                    typename SoA::reference>;
+    using pointer = void;
+
+    constexpr soa_vector_iterator() {}
+
+    constexpr soa_vector_iterator(const soa_vector_iterator &other)
+        : _ref(other._ref), _idx(other._idx) {}
+
+    template<bool Const1, typename = enable_if_t<Const && !Const1>>
+    constexpr soa_vector_iterator(const soa_vector_iterator<SoA, Const1> &other)
+        : _ref(other._ref), _idx(other._idx) {}
+
+    constexpr soa_vector_iterator &
+    operator=(const soa_vector_iterator &other) = default;
+
+    constexpr reference operator*() const {
+        return (*_ref)[_idx];
+    }
+
+    template<bool Const1>
+    constexpr bool
+    operator==(const soa_vector_iterator<SoA, Const1> &rhs) const {
+        return _idx == rhs._idx;
+    }
+
+    template<bool Const1>
+    constexpr bool
+    operator!=(const soa_vector_iterator<SoA, Const1> &rhs) const {
+        return !(*this == rhs);
+    }
+
+    template<bool Const1>
+    constexpr bool
+    operator<(const soa_vector_iterator<SoA, Const1> &rhs) const {
+        return _idx < rhs._idx;
+    }
+
+    template<bool Const1>
+    constexpr bool
+    operator>(const soa_vector_iterator<SoA, Const1> &rhs) const {
+        return rhs < *this;
+    }
+
+    template<bool Const1>
+    constexpr bool
+    operator<=(const soa_vector_iterator<SoA, Const1> &rhs) const {
+        return !(rhs < *this);
+    }
+
+    template<bool Const1>
+    constexpr bool
+    operator>=(const soa_vector_iterator<SoA, Const1> &rhs) const {
+        return !(*this < rhs);
+    }
+
+    constexpr soa_vector_iterator &operator++() {
+        ++_idx;
+        return *this;
+    }
+
+    constexpr soa_vector_iterator operator++(int) {
+        soa_vector_iterator tmp(*this);
+        ++*this;
+        return tmp;
+    }
+
+    constexpr soa_vector_iterator &operator--() {
+        --_idx;
+        return *this;
+    }
+
+    constexpr soa_vector_iterator operator--(int) {
+        soa_vector_iterator tmp(*this);
+        --*this;
+        return tmp;
+    }
+
+    constexpr soa_vector_iterator &operator+=(difference_type n) {
+        _idx += n;
+        return *this;
+    }
+
+    constexpr soa_vector_iterator &operator-=(difference_type n) {
+        _idx -= n;
+        return *this;
+    }
+
+    constexpr soa_vector_iterator operator+(difference_type n) const {
+        soa_vector_iterator tmp(*this);
+        tmp += n;
+        return tmp;
+    }
+
+    constexpr soa_vector_iterator operator-(difference_type n) const {
+        soa_vector_iterator tmp(*this);
+        tmp -= n;
+        return tmp;
+    }
+
+    template<bool Const1>
+    constexpr difference_type
+    operator-(const soa_vector_iterator<SoA, Const1> &rhs) const {
+        return (difference_type)_idx - (difference_type)rhs._idx;
+    }
+
+    friend constexpr soa_vector_iterator operator+(difference_type lhs,
+                                                   soa_vector_iterator rhs) {
+        return rhs + lhs;
+    }
+
+    constexpr reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
+protected:
+    using _ref_t = conditional_t<Const, const SoA *, SoA *>;
+
+    template<class, bool>
+    friend struct soa_vector_iterator;
+
+    template<class...>
+    friend class soa_vector;
+
+    constexpr soa_vector_iterator(_ref_t ref, size_type idx)
+        : _ref(ref), _idx(idx) {}
+
+    _ref_t _ref = nullptr;
+    size_type _idx = 0;
+};
+
+// Rows of Ts... stored column by column, each column contiguous and
+// aligned to column_alignment, all of them in one allocation. A row is a
+// tuple of references into the columns. sort and permute reorder the rows,
+// they gather every column through one permutation.
+template<class... Ts>
+class soa_vector {
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs a column");
+
+public:
+    // types:
+    using value_type = tuple<Ts...>;
+    using reference = tuple<Ts &...>;
+    using const_reference = tuple<const Ts &...>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using iterator = soa_vector_iterator<soa_vector, false>;
+    using const_iterator = soa_vector_iterator<soa_vector, true>;
+    using reverse_iterator = ala::reverse_iterator<iterator>;
+    using const_reverse_iterator = ala::reverse_iterator<const_iterator>;
+    template<size_t I>
+    using column_type = tuple_element_t<I, value_type>;
+
+    static constexpr size_t column_alignment = 64;
+    static constexpr size_t columns = sizeof...(Ts);
+
+protected:
+    using _cols_t = tuple<Ts *...>;
+    using _index_t = make_index_sequence<sizeof...(Ts)>;
+    static_assert(_maximal_<alignment_of<Ts>...>::value <= column_alignment,
+                  "column alignment exceeds column_alignment");
+
+    unsigned char *_data = nullptr;
+    size_type _capacity = 0;
+    size_type _size = 0;
+    _cols_t _cols;
+
+    static size_type _round(size_type x) noexcept {
+        return (x + column_alignment - 1) & ~(column_alignment - 1);
+    }
+
+    // offsets of the columns in a block of n rows, off[columns] its size
+    static void _offsets(size_type n, size_type *off) noexcept {
+        const size_type sizes[] = {sizeof(Ts)...};
+        size_type o = 0;
+        for (size_t k = 0; k != columns; ++k) {
+            off[k] = o;
+            o = _round(o + sizes[k] * n);
+        }
+        off[columns] = o;
+    }
+
+    static size_type _bytes(size_type n) noexcept {
+        size_type off[columns + 1];
+        _offsets(n, off);
+        return off[columns];
+    }
+
+    template<size_t... Is>
+    static _cols_t _layout(unsigned char *p, size_type n,
+                           index_sequence<Is...>) noexcept {
+        size_type off[columns + 1];
+        _offsets(n, off);
+        return _cols_t(reinterpret_cast<Ts *>(p + off[Is])...);
+    }
+
+    // storage for n rows, nothing constructed
+    struct _block {
+        unsigned char *_p = nullptr;
+        size_type _n = 0;
+        _cols_t _cols;
+
+        explicit _block(size_type n): _n(n) {
+            if (n != 0)
+                _p = static_cast<unsigned char *>(
+                    allocator<unsigned char>().allocate_bytes(
+                        _bytes(n), column_alignment));
+            _cols = _layout(_p, n, _index_t{});
+        }
+
+        _block(const _block &) = delete;
+        _block &operator=(const _block &) = delete;
+
+        ~_block() {
+            if (_p != nullptr)
+                allocator<unsigned char>().deallocate_bytes(_p, _bytes(_n),
+                                                            column_alignment);
+        }
+    };
+
+    template<size_t I>
+    column_type<I> *col() const noexcept {
+        return ala::get<I>(_cols);
+    }
+
+    // columns that move_if_noexcept copies rather than moves
+    template<class T>
+    using _copied = bool_constant<!is_nothrow_move_constructible<T>::value &&
+                                  is_copy_constructible<T>::value>;
+
+    // f(I) constructs column I of cols for rows [0, n). Step P visits
+    // column P % columns, the copied columns in the first round and the
+    // moved ones in the second, so a throwing copy leaves every source
+    // column intact. When a column throws the ones before it are destroyed.
+    template<size_t P = 0, class F>
+    static enable_if_t<(P < 2 * sizeof...(Ts))> each_column(_cols_t &cols,
+                                                            size_type n,
+                                                            F &f) {
+        constexpr size_t I = P % sizeof...(Ts);
+        using tag_t = bool_constant<_copied<column_type<I>>::value ==
+                                    (P < sizeof...(Ts))>;
+        soa_vector::each_column_at<P>(cols, n, f, tag_t{});
+    }
+
+    template<size_t P = 0, class F>
+    static enable_if_t<(P == 2 * sizeof...(Ts))> each_column(_cols_t &,
+                                                             size_type, F &) {}
+
+    template<size_t P, class F>
+    static void each_column_at(_cols_t &cols, size_type n, F &f, true_type) {
+        constexpr size_t I = P % sizeof...(Ts);
+        f(integral_constant<size_t, I>{});
+        try {
+            soa_vector::each_column<P + 1>(cols, n, f);
+        } catch (...) {
+            ala::destroy(ala::get<I>(cols), ala::get<I>(cols) + n);
+            throw;
+        }
+    }
+
+    template<size_t P, class F>
+    static void each_column_at(_cols_t &cols, size_type n, F &f, false_type) {
+        soa_vector::each_column<P + 1>(cols, n, f);
+    }
+
+    template<size_t I = 0>
+    static enable_if_t<(I < sizeof...(Ts))>
+    destroy_rows(const _cols_t &cols, size_type first,
+                 size_type last) noexcept {
+        ala::destroy(ala::get<I>(cols) + first, ala::get<I>(cols) + last);
+        soa_vector::destroy_rows<I + 1>(cols, first, last);
+    }
+
+    template<size_t I = 0>
+    static enable_if_t<(I == sizeof...(Ts))>
+    destroy_rows(const _cols_t &, size_type, size_type) noexcept {}
+
+    // row i of cols from one argument per column, or value initialized
+    // without
+    template<size_t I, class A, class... As>
+    static void construct_row(const _cols_t &cols, size_type i, A &&a,
+                              As &&...as) {
+        ala::construct_at(ala::get<I>(cols) + i, ala::forward<A>(a));
+        try {
+            soa_vector::construct_row<I + 1>(cols, i, ala::forward<As>(as)...);
+        } catch (...) {
+            ala::destroy_at(ala::get<I>(cols) + i);
+            throw;
+        }
+    }
+
+    template<size_t I>
+    static enable_if_t<(I < sizeof...(Ts))> construct_row(const _cols_t &cols,
+                                                          size_type i) {
+        ala::construct_at(ala::get<I>(cols) + i);
+        try {
+            soa_vector::construct_row<I + 1>(cols, i);
+        } catch (...) {
+            ala::destroy_at(ala::get<I>(cols) + i);
+            throw;
+        }
+    }
+
+    template<size_t I>
+    static enable_if_t<(I == sizeof...(Ts))> construct_row(const _cols_t &,
+                                                           size_type) {}
+
+    template<class T>
+    static enable_if_t<!_copied<T>::value> migrate(T *first, T *last,
+                                                   T *out) {
+        ala::uninitialized_move(first, last, out);
+    }
+
+    template<class T>
+    static enable_if_t<_copied<T>::value> migrate(T *first, T *last, T *out) {
+        ala::uninitialized_copy(first, last, out);
+    }
+
+    // b holds the rows now, the old storage is released
+    void adopt(_block &b, size_type size) noexcept {
+        soa_vector::destroy_rows(_cols, 0, _size);
+        ala::swap(_data, b._p);
+        ala::swap(_capacity, b._n);
+        _cols = b._cols;
+        _size = size;
+    }
+
+    // the rows [0, size()) into b
+    void transfer(_block &b) {
+        size_type sz = size();
+        auto f = [&](auto i) {
+            constexpr size_t I = decltype(i)::value;
+            soa_vector::migrate(this->col<I>(), this->col<I>() + sz,
+                                ala::get<I>(b._cols));
+        };
+        soa_vector::each_column(b._cols, sz, f);
+    }
+
+    void realloc(size_type n) {
+        _block b(n);
+        this->transfer(b);
+        this->adopt(b, size());
+    }
+
+    // realloc with row size() constructed from args first, args may refer
+    // to the old rows
+    template<class... Args>
+    void realloc_emplace(size_type n, Args &&...args) {
+        _block b(n);
+        size_type sz = size();
+        soa_vector::construct_row<0>(b._cols, sz, ala::forward<Args>(args)...);
+        try {
+            this->transfer(b);
+        } catch (...) {
+            soa_vector::destroy_rows(b._cols, sz, sz + 1);
+            throw;
+        }
+        this->adopt(b, sz + 1);
+    }
+
+    size_type expand() {
+        size_type c = capacity();
+        return c + (c >> 1) + 1;
+    }
+
+    void destroy() noexcept {
+        _block b(0);
+        this->adopt(b, 0);
+    }
+
+public:
+    // construct/copy/destroy:
+    soa_vector() noexcept {}
+
+    explicit soa_vector(size_type n) {
+        this->resize(n);
+    }
+
+    soa_vector(const soa_vector &other) {
+        _block b(other.size());
+        auto f = [&](auto i) {
+            constexpr size_t I = decltype(i)::value;
+            ala::uninitialized_copy(other.col<I>(),
+                                    other.col<I>() + other.size(),
+                                    ala::get<I>(b._cols));
+        };
+        soa_vector::each_column(b._cols, other.size(), f);
+        this->adopt(b, other.size());
+    }
+
+    soa_vector(soa_vector &&other) noexcept
+        : _data(other._data), _capacity(other._capacity), _size(other._size),
+          _cols(other._cols) {
+        other._data = nullptr;
+        other._capacity = 0;
+        other._size = 0;
+    }
+
+    soa_vector(initializer_list<value_type> il) {
+        this->reserve(il.size());
+        for (const value_type &v : il)
+            this->push_back(v);
+    }
+
+    ~soa_vector() {
+        destroy();
+    }
+
+    soa_vector &operator=(const soa_vector &other) {
+        if (this != ala::addressof(other)) {
+            soa_vector tmp(other);
+            this->swap(tmp);
+        }
+        return *this;
+    }
+
+    soa_vector &operator=(soa_vector &&other) noexcept {
+        if (this != ala::addressof(other)) {
+            destroy();
+            this->swap(other);
+        }
+        return *this;
+    }
+
+    void swap(soa_vector &other) noexcept {
+        ala::swap(_data, other._data);
+        ala::swap(_capacity, other._capacity);
+        ala::swap(_size, other._size);
+        ala::swap(_cols, other._cols);
+    }
+
+    // iterator:
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    iterator end() noexcept {
+        return iterator(this, size());
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return crbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return crend();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator(this, size());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(cend());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(cbegin());
+    }
+
+    // capacity:
+    size_type size() const noexcept {
+        return _size;
+    }
+
+    size_type max_size() const noexcept {
+        return numeric_limits<size_type>::max() / _bytes(1);
+    }
+
+    size_type capacity() const noexcept {
+        return _capacity;
+    }
+
+    ALA_NODISCARD bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    void reserve(size_type n) {
+        if (n > capacity())
+            this->realloc(n);
+    }
+
+    void shrink_to_fit() {
+        if (capacity() > size())
+            this->realloc(size());
+    }
+
+    void resize(size_type n) {
+        if (n < size()) {
+            soa_vector::destroy_rows(_cols, n, size());
+            _size = n;
+            return;
+        }
+        this->reserve(n);
+        while (size() < n)
+            this->emplace_back();
+    }
+
+    // element access:
+    reference operator[](size_type n) {
+        return this->row(n, _index_t{});
+    }
+
+    const_reference operator[](size_type n) const {
+        return this->row(n, _index_t{});
+    }
+
+    reference at(size_type n) {
+        if (!(n < size()))
+            throw out_of_range("ala::soa_vector index out of range");
+        return (*this)[n];
+    }
+
+    const_reference at(size_type n) const {
+        if (!(n < size()))
+            throw out_of_range("ala::soa_vector index out of range");
+        return (*this)[n];
+    }
+
+    reference front() {
+        return (*this)[0];
+    }
+
+    const_reference front() const {
+        return (*this)[0];
+    }
+
+    reference back() {
+        return (*this)[_size - 1];
+    }
+
+    const_reference back() const {
+        return (*this)[_size - 1];
+    }
+
+    // column access:
+    template<size_t I>
+    span<column_type<I>> column() noexcept {
+        return span<column_type<I>>(this->col<I>(), size());
+    }
+
+    template<size_t I>
+    span<const column_type<I>> column() const noexcept {
+        return span<const column_type<I>>(this->col<I>(), size());
+    }
+
+    template<size_t I>
+    column_type<I> *data() noexcept {
+        return this->col<I>();
+    }
+
+    template<size_t I>
+    const column_type<I> *data() const noexcept {
+        return this->col<I>();
+    }
+
+protected:
+    template<size_t... Is>
+    reference row(size_type n, index_sequence<Is...>) noexcept {
+        return reference(this->col<Is>()[n]...);
+    }
+
+    template<size_t... Is>
+    const_reference row(size_type n, index_sequence<Is...>) const noexcept {
+        return const_reference(this->col<Is>()[n]...);
+    }
+
+    template<class Tuple, size_t... Is>
+    void push_row(Tuple &&t, index_sequence<Is...>) {
+        this->emplace_back(ala::get<Is>(ala::forward<Tuple>(t))...);
+    }
+
+public:
+    // modifiers:
+    // one argument per column, or none for a value initialized row
+    template<class... Args>
+    reference emplace_back(Args &&...args) {
+        static_assert(sizeof...(Args) == 0 || sizeof...(Args) == columns,
+                      "soa_vector::emplace_back takes one value per column");
+        if (ALA_UNEXPECT(size() == capacity())) {
+            this->realloc_emplace(expand(), ala::forward<Args>(args)...);
+        } else {
+            soa_vector::construct_row<0>(_cols, size(),
+                                         ala::forward<Args>(args)...);
+            ++_size;
+        }
+        return back();
+    }
+
+    void push_back(const value_type &v) {
+        this->push_row(v, _index_t{});
+    }
+
+    void push_back(value_type &&v) {
+        this->push_row(ala::move(v), _index_t{});
+    }
+
+    void pop_back() {
+        soa_vector::destroy_rows(_cols, _size - 1, _size);
+        --_size;
+    }
+
+    void clear() noexcept {
+        soa_vector::destroy_rows(_cols, 0, _size);
+        _size = 0;
+    }
+
+    // row i becomes the row at perm[i], perm is a permutation of
+    // [0, size())
+    void permute(span<const size_type> perm) {
+        assert(perm.size() == size());
+        _block b(capacity());
+        size_type sz = size();
+        auto f = [&](auto i) {
+            constexpr size_t I = decltype(i)::value;
+            using T = column_type<I>;
+            T *src = this->col<I>(), *dst = ala::get<I>(b._cols);
+            size_type k = 0;
+            try {
+                for (; k != sz; ++k)
+                    ala::construct_at(dst + k, ala::move_if_noexcept(
+                                                   src[perm[k]]));
+            } catch (...) {
+                ala::destroy(dst, dst + k);
+                throw;
+            }
+        };
+        soa_vector::each_column(b._cols, sz, f);
+        this->adopt(b, sz);
+    }
+
+    // rows ordered by comp(const_reference, const_reference)
+    template<class Comp>
+    void sort(Comp comp) {
+        vector<size_type> idx(size());
+        for (size_type i = 0; i != size(); ++i)
+            idx[i] = i;
+        const soa_vector &self = *this;
+        ala::sort(idx.begin(), idx.end(), [&](size_type l, size_type r) {
+            return comp(self[l], self[r]);
+        });
+        this->permute(span<const size_type>(idx.data(), idx.size()));
+    }
+
+    void sort() {
+        this->sort(less<>());
+    }
+
+    // rows ordered by column I alone, the comparisons read only that column
+    template<size_t I, class Comp = less<>>
+    void sort_by(Comp comp = Comp()) {
+        vector<size_type> idx(size());
+        for (size_type i = 0; i != size(); ++i)
+            idx[i] = i;
+        const column_type<I> *c = this->col<I>();
+        ala::sort(idx.begin(), idx.end(), [&](size_type l, size_type r) {
+            return comp(c[l], c[r]);
+        });
+        this->permute(span<const size_type>(idx.data(), idx.size()));
+    }
+};
+
+template<class... Ts>
+constexpr size_t soa_vector<Ts...>::column_alignment;
+
+template<class... Ts>
+constexpr size_t soa_vector<Ts...>::columns;
+
+template<class... Ts>
+bool operator==(const soa_vector<Ts...> &lhs, const soa_vector<Ts...> &rhs) {
+    if (lhs.size() == rhs.size())
+        return ala::equal(lhs.begin(), lhs.end(), rhs.begin());
+    return false;
+}
+
+template<class... Ts>
+bool operator!=(const soa_vector<Ts...> &lhs, const soa_vector<Ts...> &rhs) {
+    return !(lhs == rhs);
+}
+
+template<class... Ts>
+void swap(soa_vector<Ts...> &lhs, soa_vector<Ts...> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace ala
+
+#endif // HEAD
@@ -30,7 +30,7 @@ public:
     using reference = element_type &;
     using const_reference = const element_type &;
     using iterator = pointer;
-    using reverse_iterator = reverse_iterator<iterator>;
+    using reverse_iterator = ala::reverse_iterator<iterator>;
     static constexpr size_type extent = Extent;
 
     // constructors, copy, and assignment
@@ -0,0 +1,218 @@
+#ifndef _ALA_STATIC_SEARCH_ARRAY_H
+#define _ALA_STATIC_SEARCH_ARRAY_H
+
+#include <ala/vector.h>
+#include <ala/bit.h>
+#include <ala/detail/functional_base.h>
+
+namespace ala {
+
+// A read only sorted sequence kept in Eytzinger (BFS) order, node k has
+// children 2k and 2k + 1, node 0 is a copy of a real element that searches
+// may touch but never return. Every search takes bit_width(size()) steps
+// without data dependent branches and prefetches the cache line holding the
+// descendants a few levels down, so the misses of successive levels overlap.
+// Iteration follows the storage order, the sorted order is only observable
+// through the searches.
+template<class T, class Comp = less<T>, class Alloc = allocator<T>>
+class static_search_array {
+public:
+    using value_type = T;
+    using key_compare = Comp;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using pointer = typename allocator_traits<allocator_type>::pointer;
+    using const_pointer =
+        typename allocator_traits<allocator_type>::const_pointer;
+    using iterator = const value_type *;
+    using const_iterator = const value_type *;
+
+    static_search_array() {}
+
+    explicit static_search_array(const Comp &comp,
+                                 const allocator_type &a = allocator_type())
+        : _tree(a), _comp(comp) {}
+
+    // [first, last) sorted by comp
+    template<class ForwardIter>
+    static_search_array(ForwardIter first, ForwardIter last,
+                        const Comp &comp = Comp(),
+                        const allocator_type &a = allocator_type())
+        : _tree(a), _comp(comp) {
+        this->assign(first, last);
+    }
+
+    static_search_array(initializer_list<value_type> il,
+                        const Comp &comp = Comp(),
+                        const allocator_type &a = allocator_type())
+        : static_search_array(il.begin(), il.end(), comp, a) {}
+
+    template<class ForwardIter>
+    void assign(ForwardIter first, ForwardIter last) {
+        size_type n = ala::distance(first, last);
+        _tree.clear();
+        if (n == 0)
+            return;
+        _tree.resize(n + 1, *first);
+        // in-order walk of the implicit tree, starting at its leftmost node
+        size_type k = 1;
+        while (2 * k <= n)
+            k *= 2;
+        for (; first != last; ++first) {
+            _tree[k] = *first;
+            if (2 * k + 1 <= n) {
+                k = 2 * k + 1;
+                while (2 * k <= n)
+                    k *= 2;
+            } else {
+                k >>= ala::countr_one(k) + 1;
+            }
+        }
+    }
+
+    void assign(initializer_list<value_type> il) {
+        this->assign(il.begin(), il.end());
+    }
+
+    const_iterator begin() const noexcept {
+        return this->data();
+    }
+
+    const_iterator end() const noexcept {
+        return this->data() + this->size();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return this->begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return this->end();
+    }
+
+    // storage order, size() elements
+    const value_type *data() const noexcept {
+        return _tree.empty() ? nullptr : _tree.data() + 1;
+    }
+
+    size_type size() const noexcept {
+        return _tree.empty() ? 0 : _tree.size() - 1;
+    }
+
+    ALA_NODISCARD bool empty() const noexcept {
+        return _tree.empty();
+    }
+
+    key_compare key_comp() const {
+        return _comp;
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return _tree.get_allocator();
+    }
+
+    void swap(static_search_array &other) noexcept(
+        is_nothrow_swappable<Comp>::value) {
+        ala::swap(_tree, other._tree);
+        ala::swap(_comp, other._comp);
+    }
+
+    // first element not less than key, end() if none
+    template<class K>
+    const_iterator lower_bound(const K &key) const {
+        return this->_result(this->_descend(key, false_type{}));
+    }
+
+    // first element greater than key, end() if none
+    template<class K>
+    const_iterator upper_bound(const K &key) const {
+        return this->_result(this->_descend(key, true_type{}));
+    }
+
+    template<class K>
+    const_iterator find(const K &key) const {
+        const_iterator i = this->lower_bound(key);
+        return i != this->end() && !_comp(key, *i) ? i : this->end();
+    }
+
+    template<class K>
+    bool contains(const K &key) const {
+        return this->find(key) != this->end();
+    }
+
+    // lower_bound of every key in [first, last) to out. Keys are searched
+    // in groups of 16, one level at a time, so the misses of a group
+    // overlap. Keys are copied, key types must be default constructible.
+    template<class InputIter, class OutputIter>
+    OutputIter lower_bound_many(InputIter first, InputIter last,
+                                OutputIter out) const {
+        using key_t = typename iterator_traits<InputIter>::value_type;
+        constexpr size_type group = 16;
+        key_t keys[group];
+        size_type ks[group];
+        size_type n = this->size();
+        while (first != last) {
+            size_type g = 0;
+            for (; g != group && first != last; ++g, (void)++first) {
+                keys[g] = *first;
+                ks[g] = 1;
+            }
+            for (int level = ala::bit_width(n); level > 0; --level) {
+                for (size_type i = 0; i != g; ++i) {
+                    size_type k = ks[i];
+                    const T &node = _tree[k <= n ? k : 0];
+                    k = 2 * k + (k > n || _comp(node, keys[i]));
+                    ALA_PREFETCH(_tree.data() + k);
+                    ks[i] = k;
+                }
+            }
+            for (size_type i = 0; i != g; ++i, (void)++out)
+                *out = this->_result(ks[i] >> (ala::countr_one(ks[i]) + 1));
+        }
+        return out;
+    }
+
+protected:
+    // nodes from _prefetch_scale * k on fill a cache line and all descend
+    // from k, four levels down for 4 byte T
+    static constexpr size_type _prefetch_scale =
+        64 / sizeof(T) > 1 ? 64 / sizeof(T) : 1;
+
+    vector<T, Alloc> _tree;
+    Comp _comp;
+
+    const_iterator _result(size_type k) const noexcept {
+        return k == 0 ? this->end() : _tree.data() + k;
+    }
+
+    // index of the answer, 0 if none. Upper asks !comp(key, node) instead
+    // of comp(node, key). Past the leaves k keeps turning right, the
+    // trailing ones are dropped with the turns above them.
+    template<class K, bool Upper>
+    size_type _descend(const K &key, bool_constant<Upper>) const {
+        size_type n = this->size(), k = 1;
+        for (int level = ala::bit_width(n); level > 0; --level) {
+            // past the end the root is prefetched, the pointer stays valid
+            size_type p = _prefetch_scale * k;
+            ALA_PREFETCH(_tree.data() + (p < _tree.size() ? p : 0));
+            const T &node = _tree[k <= n ? k : 0];
+            bool right = Upper ? !_comp(key, node) : _comp(node, key);
+            k = 2 * k + (k > n || right);
+        }
+        return k >> (ala::countr_one(k) + 1);
+    }
+};
+
+template<class T, class Comp, class Alloc>
+void swap(static_search_array<T, Comp, Alloc> &lhs,
+          static_search_array<T, Comp, Alloc> &rhs) noexcept(
+    noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace ala
+
+#endif // HEAD
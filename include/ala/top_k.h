@@ -0,0 +1,176 @@
+#ifndef _ALA_TOP_K_H
+#define _ALA_TOP_K_H
+
+#include <ala/algorithm.h>
+#include <ala/vector.h>
+
+namespace ala {
+
+// Keeps the k first values in Comp order (the k smallest with less) of a
+// stream, in O(k) memory. Values go to a buffer of 2k, a full buffer is
+// cut back to its best k with nth_element, which also fixes the worst of
+// them as a threshold new values must beat to be buffered. A cut costs
+// O(k) and happens at most once per k accepted values, so an accepted
+// value costs O(1) amortized instead of the O(log k) sift of a heap, and
+// a rejected one costs one comparison. Accumulators over parts of a
+// stream merge into one over the whole.
+template<class T, class Comp = less<T>, class Alloc = allocator<T>>
+class top_k {
+public:
+    using value_type = T;
+    using value_compare = Comp;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+
+    explicit top_k(size_type k, const Comp &comp = Comp(),
+                   const allocator_type &a = allocator_type())
+        : _buf(a), _k(k), _comp(comp) {
+        _buf.reserve(2 * k);
+    }
+
+    void push(const value_type &v) {
+        if (_cut ? _comp(v, _buf[_k - 1]) : _k != 0)
+            this->_accept(v);
+    }
+
+    void push(value_type &&v) {
+        if (_cut ? _comp(v, _buf[_k - 1]) : _k != 0)
+            this->_accept(ala::move(v));
+    }
+
+    template<class InputIter>
+    void push(InputIter first, InputIter last) {
+        using iter_t = typename vector<T, Alloc>::iterator;
+        if (_k != 0)
+            this->_push(first, last, _is_compact_iter2<InputIter, iter_t>{});
+    }
+
+    // values of other, as if they were pushed to this
+    void merge(const top_k &other) {
+        if (this == &other) {
+            vector<T, Alloc> values(_buf);
+            return this->push(values.begin(), values.end());
+        }
+        this->push(other._buf.begin(), other._buf.end());
+    }
+
+    // the kept values, best first
+    vector<T, Alloc> sorted() const {
+        vector<T, Alloc> result(_buf);
+        this->_finish(result);
+        return result;
+    }
+
+    // sorted() that takes the values and leaves this empty
+    vector<T, Alloc> extract() {
+        this->_finish(_buf);
+        vector<T, Alloc> result(ala::move(_buf));
+        this->clear();
+        return result;
+    }
+
+    void clear() noexcept {
+        _buf.clear();
+        _cut = false;
+    }
+
+    size_type k() const noexcept {
+        return _k;
+    }
+
+    size_type size() const noexcept {
+        return _buf.size() < _k ? _buf.size() : _k;
+    }
+
+    ALA_NODISCARD bool empty() const noexcept {
+        return _buf.empty();
+    }
+
+    value_compare value_comp() const {
+        return _comp;
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return _buf.get_allocator();
+    }
+
+    void swap(top_k &other) noexcept(is_nothrow_swappable<Comp>::value) {
+        ala::swap(_buf, other._buf);
+        ala::swap(_k, other._k);
+        ala::swap(_cut, other._cut);
+        ala::swap(_comp, other._comp);
+    }
+
+protected:
+    // [0, k) holds the best k once cut, _buf[k - 1] the worst of them
+    vector<T, Alloc> _buf;
+    size_type _k;
+    bool _cut = false;
+    Comp _comp;
+
+    // out of line, keeps the rejecting path of push small enough to inline
+    template<class V>
+    ALA_NOINLINE void _accept(V &&v) {
+        _buf.push_back(ala::forward<V>(v));
+        if (_buf.size() == 2 * _k)
+            this->_cut_back();
+    }
+
+    void _cut_back() {
+        ala::nth_element(_buf.begin(), _buf.begin() + (_k - 1), _buf.end(),
+                         _comp);
+        _buf.erase(_buf.begin() + _k, _buf.end());
+        _cut = true;
+    }
+
+    void _finish(vector<T, Alloc> &v) const {
+        if (v.size() > _k) {
+            ala::nth_element(v.begin(), v.begin() + (_k - 1), v.end(), _comp);
+            v.erase(v.begin() + _k, v.end());
+        }
+        ala::sort(v.begin(), v.end(), _comp);
+    }
+
+    template<class InputIter>
+    void _push(InputIter first, InputIter last, false_type) {
+        for (; first != last; ++first)
+            this->push(*first);
+    }
+
+    // once cut, contiguous trivial values are checked against the
+    // threshold a block at a time with a loop free of branches, which
+    // vectorizes, and a block that holds nothing better is skipped
+    template<class InputIter>
+    void _push(InputIter first, InputIter last, true_type) {
+        constexpr size_type block = 64;
+        auto p = ala::to_address(first);
+        size_type n = last - first, i = 0;
+        for (; n - i >= block; i += block) {
+            if (_cut) {
+                const T threshold = _buf[_k - 1];
+                bool any = false;
+                for (size_type j = i; j != i + block; ++j)
+                    any |= bool(_comp(p[j], threshold));
+                if (!any)
+                    continue;
+            }
+            for (size_type j = i; j != i + block; ++j)
+                this->push(p[j]);
+        }
+        for (; i != n; ++i)
+            this->push(p[i]);
+    }
+};
+
+template<class T, class Comp, class Alloc>
+void swap(top_k<T, Comp, Alloc> &lhs,
+          top_k<T, Comp, Alloc> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace ala
+
+#endif // HEAD
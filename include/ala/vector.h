@@ -4,9 +4,14 @@
 #include <ala/detail/algorithm_base.h>
 #include <ala/detail/allocator.h>
 #include <ala/detail/ptr_iterator.h>
+#include <ala/span.h>
 
 namespace ala {
 
+// v_fill argument for default initialization, trivial values are left as
+// the memory was
+struct _default_init_t {};
+
 template<class T, class Alloc = allocator<T>>
 class vector {
 public:
@@ -41,9 +46,16 @@ protected:
         _size = size;
     }
 
+    using _plain_t = _is_plain_construct<allocator_type>;
+
     template<class... V>
     pointer v_fill(pointer first, pointer last, V &&...v) {
         static_assert(sizeof...(V) == 0 || sizeof...(V) == 1, "Internal error");
+        return this->do_fill(first, last, _plain_t{}, ala::forward<V>(v)...);
+    }
+
+    template<class... V>
+    pointer do_fill(pointer first, pointer last, false_type, V &&...v) {
         pointer i = first;
         try {
             for (; i != last; ++i)
@@ -56,32 +68,75 @@ protected:
         return i;
     }
 
+    // the uninitialized algorithms store trivial values with memset
+    pointer do_fill(pointer first, pointer last, true_type) {
+        ala::uninitialized_value_construct(first, last);
+        return last;
+    }
+
+    template<class V>
+    pointer do_fill(pointer first, pointer last, true_type, V &&v) {
+        ala::uninitialized_fill(first, last, v);
+        return last;
+    }
+
+    // construct of an allocator value initializes, there is no other way
+    pointer do_fill(pointer first, pointer last, false_type, _default_init_t) {
+        return this->do_fill(first, last, false_type{});
+    }
+
+    pointer do_fill(pointer first, pointer last, true_type, _default_init_t) {
+        ala::uninitialized_default_construct(first, last);
+        return last;
+    }
+
     template<class InputIter>
     void mv(InputIter first, InputIter last, pointer out) {
-        InputIter i = first;
+        this->mv(first, last, out, _plain_t{});
+    }
+
+    template<class InputIter>
+    void mv(InputIter first, InputIter last, pointer out, false_type) {
+        pointer i = out;
         try {
-            for (; i != last; ++i, (void)++out)
-                _alloc_traits::construct(_alloc, out, ala::move(*i));
+            for (; first != last; ++first, (void)++i)
+                _alloc_traits::construct(_alloc, i, ala::move(*first));
         } catch (...) {
-            for (; i != first; ++first, (void)--out)
-                _alloc_traits::destroy(_alloc, out);
+            for (; i != out;)
+                _alloc_traits::destroy(_alloc, --i);
             throw;
         }
     }
 
+    // and copy trivially copyable ones with memmove
+    template<class InputIter>
+    void mv(InputIter first, InputIter last, pointer out, true_type) {
+        ala::uninitialized_move(first, last, out);
+    }
+
     template<class InputIter>
     void cp(InputIter first, InputIter last, pointer out) {
-        InputIter i = first;
+        this->cp(first, last, out, _plain_t{});
+    }
+
+    template<class InputIter>
+    void cp(InputIter first, InputIter last, pointer out, false_type) {
+        pointer i = out;
         try {
-            for (; i != last; ++i, (void)++out)
-                _alloc_traits::construct(_alloc, out, *i);
+            for (; first != last; ++first, (void)++i)
+                _alloc_traits::construct(_alloc, i, *first);
         } catch (...) {
-            for (; i != first; ++first, (void)--out)
-                _alloc_traits::destroy(_alloc, out);
+            for (; i != out;)
+                _alloc_traits::destroy(_alloc, --i);
             throw;
         }
     }
 
+    template<class InputIter>
+    void cp(InputIter first, InputIter last, pointer out, true_type) {
+        ala::uninitialized_copy(first, last, out);
+    }
+
     template<class InputIter, class Dummy = value_type>
     enable_if_t<(is_nothrow_move_constructible<Dummy>::value ||
                  !is_copy_constructible<Dummy>::value)>
@@ -316,7 +371,7 @@ protected:
 
 public:
     vector &operator=(const vector &other) {
-        if (this != addressof(other))
+        if (this != ala::addressof(other))
             copy_helper(other);
         return *this;
     }
@@ -324,7 +379,7 @@ public:
     vector &operator=(vector &&other) noexcept(
         _alloc_traits::propagate_on_container_move_assignment::value ||
         _alloc_traits::is_always_equal::value) {
-        if (this != addressof(other))
+        if (this != ala::addressof(other))
             move_helper(ala::move(other));
         return *this;
     }
@@ -338,7 +393,7 @@ public:
     swap(vector &other) noexcept(_alloc_traits::propagate_on_container_swap::value ||
                                  _alloc_traits::is_always_equal::value) {
         this->swap_helper(other);
-        ala::_swap_adl(_data, other._data);
+        ala::swap(_data, other._data);
         ala::_swap_adl(_capacity, other._capacity);
         ala::_swap_adl(_size, other._size);
     }
@@ -501,6 +556,44 @@ public:
         this->v_resize(n, v);
     }
 
+    // new elements are default initialized, trivial ones are not written
+    // and hold whatever the caller stores next
+    void resize_for_overwrite(size_type n) {
+        this->v_resize(n, _default_init_t{});
+    }
+
+    // op(data(), n) stores the first n elements and returns how many to keep,
+    // at most n. Elements past the old size are default initialized before.
+    template<class Op>
+    void resize_and_overwrite(size_type n, Op op) {
+        if (n > size())
+            this->resize_for_overwrite(n);
+        size_type r = static_cast<size_type>(ala::move(op)(data(), n));
+        assert(r <= n);
+        this->cut(begin() + r);
+    }
+
+    // n default initialized elements at the end, to be written through the
+    // span, grows as push_back does
+    span<value_type> append_uninitialized(size_type n) {
+        size_type new_size = size() + n;
+        if (new_size > capacity()) {
+            size_type new_capa = expand();
+            if (new_capa < new_size)
+                new_capa = new_size;
+            holder_t holder(_alloc, new_capa);
+            this->v_fill(holder.get() + size(), holder.get() + new_size,
+                         _default_init_t{});
+            this->migrate(holder.get());
+            this->destroy();
+            this->update(holder.release(), new_capa, new_size);
+        } else {
+            this->v_fill(end(), end() + n, _default_init_t{});
+            _size = new_size;
+        }
+        return span<value_type>(ala::to_address(_data) + (new_size - n), n);
+    }
+
     size_type capacity() const noexcept {
         return _capacity;
     }